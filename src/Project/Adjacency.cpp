@@ -0,0 +1,152 @@
+#include "Adjacency.h"
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ADJACENCY_X86 1
+#endif
+
+typedef size_t (*AdjacencyKernel)(uint32_t, uint32_t, const uint32_t *, const uint32_t *,
+                                  size_t, uint32_t *);
+
+static size_t findAdjacentScalar(uint32_t cubeBits, uint32_t cubeDashes,
+                                 const uint32_t *bits, const uint32_t *dashes, size_t count,
+                                 uint32_t *matches) {
+    size_t found = 0;
+    for (size_t j = 0; j < count; j++) {
+        uint32_t diff = bits[j] ^ cubeBits;
+        // Branch-free: the index is always stored, the cursor only advances on a match
+        matches[found] = uint32_t(j);
+        found += (dashes[j] == cubeDashes) & (diff != 0) & ((diff & (diff - 1)) == 0);
+    }
+    return found;
+}
+
+#ifdef ADJACENCY_X86
+__attribute__((target("avx2")))
+static size_t findAdjacentAVX2(uint32_t cubeBits, uint32_t cubeDashes,
+                               const uint32_t *bits, const uint32_t *dashes, size_t count,
+                               uint32_t *matches) {
+    const __m256i b = _mm256_set1_epi32(int(cubeBits));
+    const __m256i d = _mm256_set1_epi32(int(cubeDashes));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    size_t found = 0;
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m256i diff = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(bits + j)), b);
+        __m256i sameDashes = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(dashes + j)), d);
+        __m256i isZero = _mm256_cmpeq_epi32(diff, zero);
+        __m256i singleBit = _mm256_cmpeq_epi32(_mm256_and_si256(diff, _mm256_add_epi32(diff, ones)), zero);
+        __m256i hit = _mm256_andnot_si256(isZero, _mm256_and_si256(sameDashes, singleBit));
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+        while (mask) {
+            matches[found++] = uint32_t(j + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    size_t tail = findAdjacentScalar(cubeBits, cubeDashes, bits + j, dashes + j, count - j,
+                                     matches + found);
+    for (size_t k = 0; k < tail; k++) matches[found + k] += uint32_t(j);
+    return found + tail;
+}
+
+__attribute__((target("avx512f")))
+static size_t findAdjacentAVX512(uint32_t cubeBits, uint32_t cubeDashes,
+                                 const uint32_t *bits, const uint32_t *dashes, size_t count,
+                                 uint32_t *matches) {
+    const __m512i b = _mm512_set1_epi32(int(cubeBits));
+    const __m512i d = _mm512_set1_epi32(int(cubeDashes));
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i ones = _mm512_set1_epi32(-1);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i step = _mm512_set1_epi32(16);
+    size_t found = 0;
+    size_t j = 0;
+    for (; j + 16 <= count; j += 16) {
+        __m512i diff = _mm512_xor_si512(_mm512_loadu_si512(bits + j), b);
+        __mmask16 hit = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(dashes + j), d);
+        hit &= _mm512_cmpneq_epi32_mask(diff, zero);
+        hit &= _mm512_cmpeq_epi32_mask(_mm512_and_si512(diff, _mm512_add_epi32(diff, ones)), zero);
+        _mm512_mask_compressstoreu_epi32(matches + found, hit, index);
+        found += __builtin_popcount(hit);
+        index = _mm512_add_epi32(index, step);
+    }
+    size_t tail = findAdjacentScalar(cubeBits, cubeDashes, bits + j, dashes + j, count - j,
+                                     matches + found);
+    for (size_t k = 0; k < tail; k++) matches[found + k] += uint32_t(j);
+    return found + tail;
+}
+#endif
+
+struct Dispatch {
+    AdjacencyKernel kernel;
+    const char *name;
+};
+
+static Dispatch selectKernel() {
+#ifdef ADJACENCY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return { findAdjacentAVX512, "avx512" };
+    if (__builtin_cpu_supports("avx2")) return { findAdjacentAVX2, "avx2" };
+#endif
+    return { findAdjacentScalar, "scalar" };
+}
+
+static const Dispatch &dispatch() {
+    static const Dispatch selected = selectKernel();
+    return selected;
+}
+
+size_t findAdjacent(uint32_t cubeBits, uint32_t cubeDashes,
+                    const uint32_t *bits, const uint32_t *dashes, size_t count,
+                    uint32_t *matches) {
+    return dispatch().kernel(cubeBits, cubeDashes, bits, dashes, count, matches);
+}
+
+const char *adjacencyKernelName() {
+    return dispatch().name;
+}
+
+void CubeIndex::build(const uint32_t *bits, const uint32_t *dashes, size_t count) {
+    size_t size = 1024;
+    while (size < 2 * count) size *= 2;
+    keys.assign(size, ~uint64_t(0));
+    positions.resize(size);
+    size_t mask = size - 1;
+    for (size_t k = 0; k < count; k++) {
+        uint64_t key = uint64_t(dashes[k]) << 32 | bits[k];
+        size_t i = size_t((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+        while (keys[i] != ~uint64_t(0)) i = (i + 1) & mask;
+        keys[i] = key;
+        positions[i] = uint32_t(k);
+    }
+}
+
+template <int N>
+static size_t lookupAdjacent(uint32_t cubeBits, uint32_t cubeDashes, const CubeIndex &index,
+                             uint32_t first, uint32_t last, uint32_t *matches) {
+    const uint32_t open = ~(cubeBits | cubeDashes);
+    size_t found = 0;
+    for (int v = 0; v < N; v++) {
+        if (!(open & (1u << v))) continue;
+        uint32_t j = index.find(cubeBits | (1u << v), cubeDashes);
+        if (j >= first && j < last) matches[found++] = j - first; // Missing fails the test too
+    }
+    // Ascending, as findAdjacent returns them: at most N entries
+    for (size_t i = 1; i < found; i++)
+        for (size_t k = i; k > 0 && matches[k - 1] > matches[k]; k--) swap(matches[k - 1], matches[k]);
+    return found;
+}
+
+template <int... N>
+static LookupKernel selectLookup(int numVariables, integer_sequence<int, N...>) {
+    static const LookupKernel kernels[] = { lookupAdjacent<N>... };
+    return kernels[numVariables];
+}
+
+LookupKernel lookupKernel(int numVariables) {
+    // Expression accepts up to 20 variables; packed masks have room for 32
+    if (numVariables < 0 || numVariables > 32) return nullptr;
+    return selectLookup(numVariables, make_integer_sequence<int, 33>());
+}
@@ -0,0 +1,55 @@
+// Adjacency.h
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Batch form of Term::canCombine for cubes packed as (bits, dashes), where
+// bit i of a mask is variable numVariables-1-i and dashed positions hold 0
+// in bits. Writes to matches the ascending indices j < count with
+// dashes[j] == cubeDashes and bits[j] ^ cubeBits a single set bit, and
+// returns how many were written. matches needs room for count entries.
+//
+// The implementation is picked once at start-up: AVX-512, AVX2 or scalar,
+// whichever the running CPU supports.
+size_t findAdjacent(uint32_t cubeBits, uint32_t cubeDashes,
+                    const uint32_t *bits, const uint32_t *dashes, size_t count,
+                    uint32_t *matches);
+
+// Name of the kernel findAdjacent dispatches to ("avx512", "avx2", "scalar")
+const char *adjacencyKernelName();
+
+// One merge level's cubes by (dashes, bits), for lookupAdjacent. build()
+// keeps the buffers' capacity across levels.
+struct CubeIndex {
+    static const uint32_t Missing = UINT32_MAX;
+    vector<uint64_t> keys; // dashes << 32 | bits, ~0 = free slot
+    vector<uint32_t> positions;
+
+    void build(const uint32_t *bits, const uint32_t *dashes, size_t count);
+    uint32_t find(uint32_t bits, uint32_t dashes) const {
+        size_t mask = keys.size() - 1;
+        uint64_t key = uint64_t(dashes) << 32 | bits;
+        for (size_t i = size_t((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask; keys[i] != ~uint64_t(0);
+             i = (i + 1) & mask)
+            if (keys[i] == key) return positions[i];
+        return Missing;
+    }
+};
+
+// The same matches as findAdjacent over the cubes first .. last of the
+// indexed level (indices relative to first), found by looking up the cube's
+// neighbours with one more 1 instead of scanning: numVariables probes per
+// cube rather than one compare per cube of the next group, which wins once
+// groups grow past a few hundred cubes. Kernels are specialized on the
+// variable count, so the loop over variables unrolls into straight-line
+// probes with constant masks; lookupKernel picks one once the count is known.
+typedef size_t (*LookupKernel)(uint32_t cubeBits, uint32_t cubeDashes, const CubeIndex &index,
+                               uint32_t first, uint32_t last, uint32_t *matches);
+LookupKernel lookupKernel(int numVariables);
+
+#endif // ADJACENCY_H
@@ -0,0 +1,104 @@
+#include "Approximation.h"
+#include "Term.h"
+#include <algorithm>
+
+using namespace std;
+
+static size_t literalCount(uint32_t dashes, int numVariables) {
+    return numVariables - __builtin_popcount(dashes);
+}
+
+template <class Visit> static void forEachPoint(uint32_t bits, uint32_t dashes, Visit &&visit) {
+    uint32_t sub = 0;
+    do {
+        visit(bits | sub);
+        sub = (sub - dashes) & dashes;
+    } while (sub != 0);
+}
+
+Approximation::Approximation(int numVariables, const vector<int> &onSet, const vector<int> &dcSet,
+                             const vector<double> &probability)
+    : numVariables(numVariables), spec(size_t(1) << numVariables, 0), probability(probability),
+      uniform(1.0 / double(size_t(1) << numVariables)) {
+    for (int x : onSet) spec[x] = 1;
+    for (int x : dcSet) spec[x] = 2;
+    if (this->probability.size() != spec.size()) this->probability.clear();
+}
+
+vector<Approximation::Change> Approximation::candidates(const vector<string> &cover, const vector<int> &onSet,
+                                                        const vector<int> &dcSet) const {
+    size_t points = size_t(1) << numVariables;
+    vector<uint8_t> care(points, 0);
+    for (int x : onSet) care[x] = 1;
+    for (int x : dcSet) care[x] = 2;
+
+    vector<uint32_t> bits(cover.size()), dashes(cover.size());
+    vector<int> coverCount(points, 0);
+    for (size_t c = 0; c < cover.size(); c++) {
+        Term::pack(cover[c], bits[c], dashes[c]);
+        forEachPoint(bits[c], dashes[c], [&](uint32_t x) { coverCount[x]++; });
+    }
+    // A product of more than one literal costs its literals, and every
+    // product is an input of the output gate when there is more than one
+    auto cubeCost = [&](size_t c) {
+        size_t literals = literalCount(dashes[c], numVariables);
+        return (literals > 1 ? literals : 0) + (cover.size() > 1 ? 1 : 0);
+    };
+
+    vector<Change> changes;
+    for (size_t c = 0; c < cover.size(); c++) {
+        // Drop the cube: what only it covers is given up
+        Change drop;
+        forEachPoint(bits[c], dashes[c], [&](uint32_t x) {
+            if (care[x] == 1 && coverCount[x] == 1) {
+                drop.points.push_back(int(x));
+                drop.error += weight(x);
+            }
+        });
+        drop.gain = cubeCost(c);
+        if (drop.gain > 0) changes.push_back(drop);
+
+        // Raise one literal: the off-set points of the other half are given
+        // up, and cubes inside the larger cube go with it
+        for (int v = 0; v < numVariables; v++) {
+            uint32_t bit = 1u << v;
+            if (dashes[c] & bit) continue;
+            Change raise;
+            forEachPoint(bits[c] ^ bit, dashes[c], [&](uint32_t x) {
+                if (care[x] == 0) {
+                    raise.points.push_back(int(x));
+                    raise.error += weight(x);
+                }
+            });
+            if (raise.points.empty()) continue;
+            uint32_t grownBits = bits[c] & ~bit, grownDashes = dashes[c] | bit;
+            size_t literals = literalCount(dashes[c], numVariables);
+            raise.gain = (literals > 1 ? literals : 0) - (literals > 2 ? literals - 1 : 0);
+            for (size_t d = 0; d < cover.size(); d++)
+                if (d != c && (dashes[d] & grownDashes) == dashes[d] && ((bits[d] ^ grownBits) & ~grownDashes) == 0)
+                    raise.gain += cubeCost(d);
+            changes.push_back(raise);
+        }
+    }
+
+    // Most gain per unit of error first; points with no probability at all
+    // cost nothing
+    stable_sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+        return a.gain * b.error > b.gain * a.error ||
+               (a.gain * b.error == b.gain * a.error && a.points.size() < b.points.size());
+    });
+    return changes;
+}
+
+vector<int> Approximation::errors(const vector<string> &cover) const {
+    vector<uint8_t> value(spec.size(), 0);
+    for (const auto &cube : cover) {
+        uint32_t bits, dashes;
+        Term::pack(cube, bits, dashes);
+        forEachPoint(bits, dashes, [&](uint32_t x) { value[x] = 1; });
+    }
+    vector<int> wrong;
+    for (size_t x = 0; x < spec.size(); x++)
+        if (spec[x] != 2 && spec[x] != value[x]) wrong.push_back(int(x));
+    return wrong;
+}
@@ -0,0 +1,46 @@
+// Approximation.h
+#ifndef APPROXIMATION_H
+#define APPROXIMATION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Finds where a cover can get cheaper by giving up a few outputs. Two kinds
+// of change are proposed, both as points to turn into don't-cares:
+//  - drop a cube: the on-set points only it covers,
+//  - raise a literal of a cube: the off-set points of the half it grows into.
+// Each comes with the gate inputs it is expected to save and the error it
+// may cost, and the caller re-minimizes with the points as don't-cares to
+// see what it really saves.
+class Approximation {
+public:
+    struct Change {
+        vector<int> points; // points that become don't-cares
+        double error = 0;   // their total probability
+        size_t gain = 0;    // gate inputs the change is expected to save
+    };
+
+    // probability[x] is how likely input x is; empty means all are equally
+    // likely. onSet and dcSet are the function as specified.
+    Approximation(int numVariables, const vector<int> &onSet, const vector<int> &dcSet,
+                  const vector<double> &probability);
+
+    // Changes to cover, a cover of the function whose on/dc points are given
+    // (the spec with earlier changes applied), most gain per error first
+    vector<Change> candidates(const vector<string> &cover, const vector<int> &onSet,
+                              const vector<int> &dcSet) const;
+    // Points where cover differs from the spec (don't-cares aside), ascending
+    vector<int> errors(const vector<string> &cover) const;
+    double weight(int x) const { return probability.empty() ? uniform : probability[x]; }
+
+private:
+    int numVariables;
+    vector<uint8_t> spec; // per point: 0 off, 1 on, 2 don't-care
+    vector<double> probability;
+    double uniform;
+};
+
+#endif // APPROXIMATION_H
@@ -0,0 +1,223 @@
+#include "BatchQueue.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#ifdef _WIN32
+#include <process.h>
+#include <cstdlib>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+BatchQueue::BatchQueue(const string &root) : root(root) {}
+
+bool BatchQueue::create(string &error) {
+    error_code ec;
+    for (const char *dir : { "pending", "claimed", "done", "reports" }) {
+        fs::create_directories(fs::path(root) / dir, ec);
+        if (ec) {
+            error = "Unable to create " + (fs::path(root) / dir).string() + ": " + ec.message();
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BatchQueue::enqueue(const vector<string> &files, string &error) {
+    size_t queued = 0;
+    // Specs a worker is holding right now; spec names have no '@'
+    set<string> claimed;
+    error_code listError;
+    for (const auto &entry : fs::directory_iterator(fs::path(root) / "claimed", listError)) {
+        string name = entry.path().filename().string();
+        claimed.insert(name.substr(0, name.find('@')));
+    }
+    for (const auto &file : files) {
+        string name = fs::path(file).filename().string();
+        fs::path target = fs::path(root) / "pending" / name;
+        if (name.find('@') != string::npos) {
+            error = "Spec names may not contain '@': " + name;
+            continue;
+        }
+        if (fs::exists(target) || claimed.count(name) ||
+            fs::exists(fs::path(root) / "done" / (name + ".out")))
+            continue;
+        // Copy next to the queue, then rename in, so no worker sees half a file
+        fs::path staging = fs::path(root) / ("." + name + ".enqueue");
+        error_code ec;
+        fs::copy_file(file, staging, fs::copy_options::overwrite_existing, ec);
+        if (!ec) fs::rename(staging, target, ec);
+        if (ec) {
+            error = "Unable to queue " + file + ": " + ec.message();
+            fs::remove(staging, ec);
+            continue;
+        }
+        queued++;
+    }
+    return queued;
+}
+
+bool BatchQueue::claim(const string &worker, Claim &claim) {
+    for (int pass = 0; pass < 3; pass++) {
+        if (next >= listing.size()) {
+            // Read pending/ again, in a worker-specific order so that
+            // workers starting together do not all race for one file
+            listing.clear();
+            next = 0;
+            error_code ec;
+            for (const auto &entry : fs::directory_iterator(fs::path(root) / "pending", ec))
+                listing.push_back(entry.path().filename().string());
+            if (listing.empty()) return false;
+            sort(listing.begin(), listing.end());
+            shuffle(listing.begin(), listing.end(), mt19937(uint32_t(hash<string>()(worker))));
+        }
+        for (; next < listing.size(); next++) {
+            fs::path from = fs::path(root) / "pending" / listing[next];
+            fs::path to = fs::path(root) / "claimed" / (listing[next] + "@" + worker);
+            error_code ec;
+            fs::rename(from, to, ec);
+            if (ec) continue; // another worker got it first
+            claim.spec = listing[next++];
+            claim.path = to.string();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BatchQueue::publish(const Claim &claim, const string &worker, const string &result, string &error) {
+    fs::path target = fs::path(root) / "done" / (claim.spec + ".out");
+    fs::path staging = fs::path(root) / "done" / ("." + claim.spec + ".out@" + worker);
+    {
+        ofstream out(staging, ios::binary);
+        out << result;
+        if (!out.flush()) {
+            error = "Unable to write " + staging.string();
+            return false;
+        }
+    }
+    error_code ec;
+    fs::rename(staging, target, ec);
+    if (ec) {
+        error = "Unable to publish " + target.string() + ": " + ec.message();
+        return false;
+    }
+    fs::remove(claim.path, ec);
+    return true;
+}
+
+void BatchQueue::report(const string &worker, const string &line) {
+    ofstream out(fs::path(root) / "reports" / (worker + ".tsv"), ios::app);
+    out << line << '\n';
+}
+
+size_t BatchQueue::requeue(const string &worker) {
+    size_t moved = 0;
+    error_code ec;
+    for (const auto &entry : fs::directory_iterator(fs::path(root) / "claimed", ec)) {
+        string name = entry.path().filename().string();
+        size_t at = name.rfind('@');
+        if (at == string::npos) continue;
+        if (!worker.empty() && name.compare(at + 1, string::npos, worker) != 0) continue;
+        error_code renameError;
+        fs::rename(entry.path(), fs::path(root) / "pending" / name.substr(0, at), renameError);
+        if (!renameError) moved++;
+    }
+    return moved;
+}
+
+bool BatchQueue::mergeReports(ostream &summary, string &error) {
+    struct Row {
+        string spec, worker, status;
+        double ms = 0;
+        string rest;
+    };
+    vector<Row> rows;
+    error_code ec;
+    for (const auto &entry : fs::directory_iterator(fs::path(root) / "reports", ec)) {
+        if (entry.path().extension() != ".tsv") continue;
+        ifstream in(entry.path());
+        string line;
+        while (getline(in, line)) {
+            stringstream fields(line);
+            Row row;
+            string ms;
+            if (!getline(fields, row.spec, '\t') || !getline(fields, row.worker, '\t') ||
+                !getline(fields, row.status, '\t') || !getline(fields, ms, '\t'))
+                continue; // a line cut short by a worker that died
+            row.ms = atof(ms.c_str());
+            getline(fields, row.rest);
+            rows.push_back(row);
+        }
+    }
+    if (ec) {
+        error = "Unable to read " + (fs::path(root) / "reports").string() + ": " + ec.message();
+        return false;
+    }
+    sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.spec < b.spec; });
+
+    fs::path target = fs::path(root) / "report.tsv";
+    fs::path staging = fs::path(root) / ".report.tsv";
+    {
+        ofstream out(staging);
+        out << "spec\tworker\tstatus\tms\tvariables\tcubes\n";
+        for (const auto &row : rows)
+            out << row.spec << '\t' << row.worker << '\t' << row.status << '\t' << fixed << setprecision(3)
+                << row.ms << '\t' << row.rest << '\n';
+        if (!out.flush()) {
+            error = "Unable to write " + staging.string();
+            return false;
+        }
+    }
+    fs::rename(staging, target, ec);
+    if (ec) {
+        error = "Unable to write " + target.string() + ": " + ec.message();
+        return false;
+    }
+
+    map<string, size_t> statuses;
+    map<string, pair<size_t, double>> workers; // specs, total ms
+    vector<double> times;
+    for (const auto &row : rows) {
+        statuses[row.status]++;
+        workers[row.worker].first++;
+        workers[row.worker].second += row.ms;
+        times.push_back(row.ms);
+    }
+    sort(times.begin(), times.end());
+    auto percentile = [&](double p) { return times.empty() ? 0.0 : times[size_t(p * (times.size() - 1))]; };
+    double total = 0;
+    for (double t : times) total += t;
+
+    summary << fixed << setprecision(3);
+    summary << "specs: " << rows.size() << "\n";
+    for (const auto &[status, count] : statuses) summary << "  " << status << ": " << count << "\n";
+    summary << "time ms: total " << total << ", mean " << (times.empty() ? 0.0 : total / times.size())
+            << ", p50 " << percentile(0.5) << ", p95 " << percentile(0.95) << ", max "
+            << (times.empty() ? 0.0 : times.back()) << "\n";
+    summary << "workers: " << workers.size() << "\n";
+    for (const auto &[worker, load] : workers)
+        summary << "  " << worker << ": " << load.first << " specs, " << load.second << " ms\n";
+    summary << "merged report: " << target.string() << "\n";
+    return true;
+}
+
+string BatchQueue::defaultWorkerId() {
+#ifdef _WIN32
+    const char *host = getenv("COMPUTERNAME");
+    return string(host ? host : "host") + "." + to_string(_getpid());
+#else
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    return string(host) + "." + to_string(getpid());
+#endif
+}
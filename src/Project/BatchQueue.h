@@ -0,0 +1,54 @@
+// BatchQueue.h
+#ifndef BATCHQUEUE_H
+#define BATCHQUEUE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Directory work queue shared by worker processes on one or more machines.
+// Every state change is a rename inside the queue directory, which the
+// filesystem does atomically, so workers need no locks and no coordinator
+// while they run:
+//   pending/<spec>            waiting to be claimed
+//   claimed/<spec>@<worker>   the rename out of pending succeeds for one worker only
+//   done/<spec>.out           result, written under a temporary name and renamed in
+//   reports/<worker>.tsv      appended by its worker only: spec, worker, status,
+//                             milliseconds, variables, cubes in the first cover
+class BatchQueue {
+public:
+    struct Claim {
+        string spec;   // file name in pending/
+        string path;   // where the claimed file now is
+    };
+
+    explicit BatchQueue(const string &root);
+
+    bool create(string &error); // makes the directories if missing
+    // Copies spec files into pending/; a spec already queued, claimed or done
+    // under the same name is skipped. Returns how many were queued.
+    size_t enqueue(const vector<string> &files, string &error);
+    // Claims the next pending spec for worker; false when none is left
+    bool claim(const string &worker, Claim &claim);
+    // Publishes the result of a claimed spec and retires the claim
+    bool publish(const Claim &claim, const string &worker, const string &result, string &error);
+    void report(const string &worker, const string &line);
+    // Puts specs claimed by worker ("" = any worker) back into pending/,
+    // for workers that died. Returns how many were moved.
+    size_t requeue(const string &worker);
+    // Merges every worker report into report.tsv (sorted by spec) and
+    // writes a summary: per-status counts, time percentiles, per-worker load
+    bool mergeReports(ostream &summary, string &error);
+
+    // host.pid, unique among the processes sharing the queue
+    static string defaultWorkerId();
+
+private:
+    string root;
+    vector<string> listing; // pending/ as last listed, tried in order
+    size_t next = 0;
+};
+
+#endif // BATCHQUEUE_H
@@ -0,0 +1,126 @@
+#include "BitmapEngine.h"
+#include <algorithm>
+#include <map>
+
+using namespace std;
+
+typedef vector<uint64_t> Bitmap;
+
+// Bits of a word whose position has bit b clear, for b < 6
+static const uint64_t lowBitClear[6] = {
+    0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+    0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL
+};
+
+bool BitmapEngine::preferred(int numVariables, size_t termCount) {
+    // Dense means at least one point in 64 is set: the pairwise merge then
+    // grows quadratically while a sweep touches each word once per variable.
+    return numVariables <= 20 && termCount * 64 >= (size_t(1) << numVariables);
+}
+
+// next[x] = current[x] & current[x + 2^b] for every x with bit b clear
+static void eliminate(const Bitmap &current, Bitmap &next, int b) {
+    size_t words = current.size();
+    if (b < 6) {
+        uint64_t keep = lowBitClear[b];
+        int shift = 1 << b;
+        for (size_t w = 0; w < words; w++)
+            next[w] = current[w] & (current[w] >> shift) & keep;
+    } else {
+        size_t stride = size_t(1) << (b - 6);
+        for (size_t base = 0; base < words; base += 2 * stride) {
+            for (size_t w = base; w < base + stride; w++)
+                next[w] = current[w] & current[w + stride];
+            fill(next.begin() + base + stride, next.begin() + base + 2 * stride, 0);
+        }
+    }
+}
+
+// absorbed gets both halves of every cube in child, which eliminated bit b
+static void absorb(const Bitmap &child, Bitmap &absorbed, int b) {
+    size_t words = child.size();
+    if (b < 6) {
+        int shift = 1 << b;
+        for (size_t w = 0; w < words; w++)
+            absorbed[w] |= child[w] | (child[w] << shift);
+    } else {
+        size_t stride = size_t(1) << (b - 6);
+        for (size_t base = 0; base < words; base += 2 * stride) {
+            for (size_t w = base; w < base + stride; w++) {
+                absorbed[w] |= child[w];
+                absorbed[w + stride] |= child[w];
+            }
+        }
+    }
+}
+
+static bool isEmpty(const Bitmap &bitmap) {
+    for (uint64_t word : bitmap)
+        if (word) return false;
+    return true;
+}
+
+bool BitmapEngine::generate(int numVariables, const vector<Term> &terms, vector<Term> &primes,
+                            size_t memoryLimit, const CancelToken *cancel) {
+    size_t points = size_t(1) << numVariables;
+    size_t words = (points + 63) / 64;
+    size_t bitmapBytes = words * sizeof(uint64_t);
+
+    // Level k maps each set of k eliminated variables to its implicant bitmap
+    map<uint32_t, Bitmap> level;
+    Bitmap &base = level[0];
+    base.assign(words, 0);
+    for (const auto &term : terms)
+        base[term.value >> 6] |= uint64_t(1) << (term.value & 63);
+
+    vector<Term> found;
+    while (!level.empty()) {
+        if (level.size() * 2 * bitmapBytes > memoryLimit) return false;
+        map<uint32_t, Bitmap> nextLevel;
+        map<uint32_t, Bitmap> absorbed;
+        for (const auto &[dashes, bitmap] : level)
+            absorbed[dashes].assign(words, 0);
+
+        // Each child is derived once, from the parent missing its highest bit
+        Bitmap child(words);
+        for (const auto &[dashes, bitmap] : level) {
+            if (cancel && cancel->stopRequested()) return false;
+            for (int b = numVariables - 1; b >= 0 && !(dashes >> b); b--) {
+                eliminate(bitmap, child, b);
+                if (isEmpty(child)) continue;
+                nextLevel.emplace(dashes | (1u << b), child);
+                if ((level.size() * 2 + nextLevel.size()) * bitmapBytes > memoryLimit) return false;
+            }
+        }
+
+        // A child absorbs its halves in every parent, not only the one it came from
+        for (const auto &[childDashes, bitmap] : nextLevel) {
+            for (int b = 0; b < numVariables; b++) {
+                if (!(childDashes & (1u << b))) continue;
+                absorb(bitmap, absorbed[childDashes & ~(1u << b)], b);
+            }
+        }
+
+        vector<Term> levelPrimes;
+        for (const auto &[dashes, bitmap] : level) {
+            const Bitmap &covered = absorbed[dashes];
+            for (size_t w = 0; w < words; w++) {
+                uint64_t left = bitmap[w] & ~covered[w];
+                while (left) {
+                    int bit = __builtin_ctzll(left);
+                    left &= left - 1;
+                    levelPrimes.push_back(Term::fromCube(uint32_t(w * 64 + bit), dashes, numVariables));
+                }
+            }
+        }
+        stable_sort(levelPrimes.begin(), levelPrimes.end(), [](const Term &a, const Term &b) {
+            int onesA = Term::countOnes(a.binary), onesB = Term::countOnes(b.binary);
+            return onesA != onesB ? onesA < onesB : a.binary < b.binary;
+        });
+        found.insert(found.end(), levelPrimes.begin(), levelPrimes.end());
+        level.swap(nextLevel);
+    }
+
+    primes.insert(primes.end(), found.begin(), found.end());
+    return true;
+}
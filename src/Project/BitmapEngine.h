@@ -0,0 +1,30 @@
+// BitmapEngine.h
+#ifndef BITMAPENGINE_H
+#define BITMAPENGINE_H
+
+#include "CancelToken.h"
+#include "Term.h"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Prime implicant generation for dense functions. The on-set plus
+// don't-cares is held as a 2^n bitmap; for every set D of eliminated
+// variables, bit x of level[D] says the cube "x with the variables in D
+// replaced by -" is an implicant. Adding variable v to D is a shift by
+// 2^v and an AND over whole words, and a cube is prime when no cube of the
+// next level absorbs it.
+class BitmapEngine {
+public:
+    // True when the bitmap sweep is expected to beat the tabular merge
+    static bool preferred(int numVariables, size_t termCount);
+    // Fills primes in the same order the tabular method would group them
+    // (by number of dashes, then number of ones). Returns false, leaving
+    // primes untouched, if the bitmaps would need more than memoryLimit bytes
+    // or a stop was requested.
+    static bool generate(int numVariables, const vector<Term> &terms, vector<Term> &primes,
+                         size_t memoryLimit = size_t(1) << 30, const CancelToken *cancel = nullptr);
+};
+
+#endif // BITMAPENGINE_H
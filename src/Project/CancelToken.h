@@ -0,0 +1,36 @@
+// CancelToken.h
+#ifndef CANCELTOKEN_H
+#define CANCELTOKEN_H
+
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+// Polled by every stage of a run (prime implicant generation, dominance,
+// covering). A stage that sees a stop request keeps what it has, so the
+// run still ends with a valid cover, just not a guaranteed minimal one.
+// Stops on cancel(), on its own deadline, or when its parent stops.
+class CancelToken {
+public:
+    explicit CancelToken(const CancelToken *parent = nullptr) : parent(parent) {}
+
+    void cancel() { cancelled = true; }
+    void setTimeLimit(chrono::milliseconds limit) {
+        deadline = chrono::steady_clock::now() + limit;
+        timed = true;
+    }
+    bool stopRequested() const {
+        if (cancelled.load(memory_order_relaxed)) return true;
+        if (timed && chrono::steady_clock::now() >= deadline) return true;
+        return parent && parent->stopRequested();
+    }
+
+private:
+    atomic<bool> cancelled{false};
+    bool timed = false;
+    chrono::steady_clock::time_point deadline;
+    const CancelToken *parent;
+};
+
+#endif // CANCELTOKEN_H
@@ -0,0 +1,126 @@
+#include "ConsensusEngine.h"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+using namespace std;
+
+typedef pair<uint32_t, uint32_t> Cube; // (dashes, bits)
+
+// Kept cubes as a ternary trie over the variables: child 0, 1 or 2 (dash)
+// for the variable at each depth. A cube is inside a kept one when a path
+// takes, at every variable, the cube's own literal or a dash (a dash where
+// the cube has one), so a lookup only walks the branches that could hold
+// it instead of testing every kept cube.
+class CubeTrie {
+public:
+    explicit CubeTrie(int numVariables) : numVariables(numVariables), nodes(1, Node{ { 0, 0, 0 } }) {}
+
+    void insert(uint32_t dashes, uint32_t bits) {
+        uint32_t node = 0;
+        for (int v = 0; v < numVariables; v++) {
+            int branch = childOf(dashes, bits, v);
+            if (nodes[node][branch] == 0) {
+                nodes[node][branch] = uint32_t(nodes.size());
+                nodes.push_back(Node{ { 0, 0, 0 } });
+            }
+            node = nodes[node][branch];
+        }
+    }
+
+    bool holds(uint32_t dashes, uint32_t bits) const { return holds(0, 0, dashes, bits); }
+
+private:
+    typedef array<uint32_t, 3> Node; // 0 = no child; the root is never a child
+
+    static int childOf(uint32_t dashes, uint32_t bits, int v) {
+        return dashes >> v & 1 ? 2 : int(bits >> v & 1);
+    }
+
+    bool holds(uint32_t node, int v, uint32_t dashes, uint32_t bits) const {
+        if (v == numVariables) return true;
+        int branch = childOf(dashes, bits, v);
+        if (branch != 2 && nodes[node][branch] && holds(nodes[node][branch], v + 1, dashes, bits)) return true;
+        return nodes[node][2] && holds(nodes[node][2], v + 1, dashes, bits);
+    }
+
+    int numVariables;
+    vector<Node> nodes;
+};
+
+// Drops duplicates and every cube inside another one. Larger cubes come
+// first, so a cube is only checked against kept cubes that could hold it.
+static void absorb(vector<Cube> &cubes, int numVariables) {
+    sort(cubes.begin(), cubes.end(), [](const Cube &a, const Cube &b) {
+        int dashesA = __builtin_popcount(a.first), dashesB = __builtin_popcount(b.first);
+        return dashesA != dashesB ? dashesA > dashesB : a < b;
+    });
+    vector<Cube> kept;
+    CubeTrie trie(numVariables);
+    for (const auto &[dashes, bits] : cubes) {
+        if (trie.holds(dashes, bits)) continue;
+        trie.insert(dashes, bits);
+        kept.push_back({ dashes, bits });
+    }
+    cubes.swap(kept);
+}
+
+bool ConsensusEngine::preferred(const vector<uint32_t> &dashes) {
+    size_t cubes = 0, loose = 0;
+    double cubePoints = 0;
+    for (uint32_t d : dashes) {
+        if (d == 0) {
+            loose++;
+            continue;
+        }
+        cubes++;
+        cubePoints += double(uint64_t(1) << __builtin_popcount(d));
+    }
+    return cubes > 0 && cubePoints >= 256.0 * cubes && 16.0 * loose <= cubePoints + loose;
+}
+
+bool ConsensusEngine::generate(int numVariables, const vector<uint32_t> &bits, const vector<uint32_t> &dashes,
+                               vector<Term> &primes, const CancelToken *cancel) {
+    vector<Cube> cubes(bits.size());
+    for (size_t i = 0; i < bits.size(); i++) cubes[i] = { dashes[i], bits[i] & ~dashes[i] };
+    absorb(cubes, numVariables);
+
+    bool complete = true;
+    for (int v = 0; v < numVariables; v++) {
+        if (cancel && cancel->stopRequested()) {
+            complete = false;
+            break;
+        }
+        uint32_t bit = 1u << v;
+        vector<Cube> zeros, ones;
+        for (const auto &cube : cubes) {
+            if (cube.first & bit) continue;
+            (cube.second & bit ? ones : zeros).push_back(cube);
+        }
+        size_t before = cubes.size();
+        for (const auto &[zeroDashes, zeroBits] : zeros) {
+            for (const auto &[oneDashes, oneBits] : ones) {
+                // Opposite only in v: the consensus frees v and keeps every
+                // literal either side fixes
+                if (((zeroBits ^ oneBits) & ~(zeroDashes | oneDashes)) != bit) continue;
+                uint32_t consensusDashes = (zeroDashes & oneDashes) | bit;
+                cubes.push_back({ consensusDashes, (zeroBits | oneBits) & ~consensusDashes });
+            }
+        }
+        if (cubes.size() > before) absorb(cubes, numVariables);
+    }
+
+    // By number of dashes, then number of ones, then binary
+    vector<Term> found;
+    for (const auto &[cubeDashes, cubeBits] : cubes)
+        found.push_back(Term::fromCube(cubeBits, cubeDashes, numVariables));
+    stable_sort(found.begin(), found.end(), [](const Term &a, const Term &b) {
+        size_t dashesA = count(a.binary.begin(), a.binary.end(), '-');
+        size_t dashesB = count(b.binary.begin(), b.binary.end(), '-');
+        if (dashesA != dashesB) return dashesA < dashesB;
+        int onesA = Term::countOnes(a.binary), onesB = Term::countOnes(b.binary);
+        return onesA != onesB ? onesA < onesB : a.binary < b.binary;
+    });
+    primes.insert(primes.end(), found.begin(), found.end());
+    return complete;
+}
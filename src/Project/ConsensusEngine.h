@@ -0,0 +1,35 @@
+// ConsensusEngine.h
+#ifndef CONSENSUSENGINE_H
+#define CONSENSUSENGINE_H
+
+#include "CancelToken.h"
+#include "Term.h"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Prime implicant generation from cubes rather than minterms (Tison's
+// iterated consensus). For each variable in turn, every pair of cubes with
+// opposite literals in it and no other conflict adds their consensus, and
+// cubes inside another cube are dropped; after the last variable the cubes
+// left are exactly the primes. Cubes merged by an upstream tool therefore
+// never have to be rebuilt from their minterms.
+class ConsensusEngine {
+public:
+    // True when growing primes from these seeds (their dash masks) is
+    // expected to beat the bitmap or tabular engines on their points. Those
+    // build every subcube of a seed while consensus pairs seeds, so it only
+    // wins for large cubes (256 points on average) with few minterms
+    // outside them (under 1 point in 16).
+    static bool preferred(const vector<uint32_t> &dashes);
+    // The seed cubes (bits, dashes; dashes read as 0 in bits) must lie in
+    // the on-set plus don't-cares and together cover it. Fills primes in
+    // the order of the other generators. When a stop is requested the cubes
+    // so far are appended, which still cover the function though not all
+    // are prime, and false is returned.
+    static bool generate(int numVariables, const vector<uint32_t> &bits, const vector<uint32_t> &dashes,
+                         vector<Term> &primes, const CancelToken *cancel = nullptr);
+};
+
+#endif // CONSENSUSENGINE_H
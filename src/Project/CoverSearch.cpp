@@ -0,0 +1,206 @@
+#include "CoverSearch.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <thread>
+
+using namespace std;
+
+CoverSearch::CoverSearch(const vector<vector<int>> &chart) : best(SIZE_MAX), pending(0), stopped(false) {
+    // Renumber the columns densely so every buffer is sized by this chart
+    map<int, int> local;
+    for (const auto &row : chart) {
+        vector<int> ids;
+        for (int c : row) {
+            auto it = local.emplace(c, original.size()).first;
+            if (it->second == (int)original.size()) {
+                original.push_back(c);
+                columns.emplace_back();
+            }
+            ids.push_back(it->second);
+            columns[it->second].push_back(rows.size());
+        }
+        rows.push_back(ids);
+    }
+}
+
+bool CoverSearch::preferred(const vector<vector<int>> &rows) {
+    // The Petrick product has up to prod(|row|) terms before absorption
+    double terms = 0;
+    for (const auto &row : rows) terms += log2((double)max<size_t>(row.size(), 1));
+    return terms > 12;
+}
+
+vector<vector<int>> CoverSearch::solve(ThreadPool *pool, const vector<int> &incumbent,
+                                       const CancelToken *cancelToken) {
+    // Taking one column per row is always a cover
+    best = rows.size();
+    found.clear();
+    stopped = false;
+    cancel = cancelToken;
+    if (!incumbent.empty()) {
+        map<int, int> local;
+        for (size_t c = 0; c < original.size(); c++) local[original[c]] = c;
+        vector<int> chosen;
+        for (int c : incumbent) chosen.push_back(local.at(c));
+        record(chosen);
+    }
+    queueCount = pool ? max<size_t>(pool->size(), 1) : 1;
+    queues.reset(new WorkQueue[queueCount]);
+
+    queues[0].nodes.push_back(Node{ {}, vector<uint8_t>(columns.size(), 0) });
+    pending = 1;
+    if (queueCount > 1) {
+        vector<function<void()>> jobs;
+        for (size_t t = 0; t < queueCount; t++)
+            jobs.push_back([this, t] { worker(t); });
+        pool->runAll(jobs);
+    } else {
+        worker(0);
+    }
+
+    // The incumbent may be found again by the search
+    sort(found.begin(), found.end());
+    found.erase(unique(found.begin(), found.end()), found.end());
+    return found;
+}
+
+void CoverSearch::worker(size_t self) {
+    vector<int> covered(rows.size());
+    vector<uint8_t> mark(columns.size(), 0);
+    Node node;
+    while (pending > 0 && !stopped) {
+        if (!takeNode(self, node)) {
+            this_thread::yield();
+            continue;
+        }
+        fill(covered.begin(), covered.end(), 0);
+        for (int c : node.chosen)
+            for (int r : columns[c]) covered[r]++;
+        search(node, covered, mark, self);
+        pending--;
+    }
+}
+
+// Own deque from the back (depth first), everyone else's from the front
+// (the shallowest, largest subtrees)
+bool CoverSearch::takeNode(size_t self, Node &node) {
+    for (size_t k = 0; k < queueCount; k++) {
+        WorkQueue &queue = queues[(self + k) % queueCount];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.nodes.empty()) continue;
+        if (k == 0) {
+            node = move(queue.nodes.back());
+            queue.nodes.pop_back();
+        } else {
+            node = move(queue.nodes.front());
+            queue.nodes.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void CoverSearch::search(Node &node, vector<int> &covered, vector<uint8_t> &mark, size_t self) {
+    if (stopped) return;
+    if (cancel && cancel->stopRequested()) {
+        stopped = true;
+        return;
+    }
+    size_t cost = node.chosen.size();
+    if (cost > best.load(memory_order_relaxed)) return;
+
+    // Branch on the uncovered row with the fewest columns still allowed
+    int branchRow = -1;
+    size_t fewest = SIZE_MAX;
+    for (size_t r = 0; r < rows.size(); r++) {
+        if (covered[r]) continue;
+        size_t allowed = 0;
+        for (int c : rows[r]) allowed += !node.banned[c];
+        if (allowed == 0) return;
+        if (allowed < fewest) {
+            fewest = allowed;
+            branchRow = r;
+        }
+    }
+    if (branchRow < 0) {
+        record(node.chosen);
+        return;
+    }
+    if (cost + lowerBound(node, covered, mark) > best.load(memory_order_relaxed)) return;
+
+    // Columns covering the most open rows first, so good covers come early
+    vector<pair<int, int>> order;
+    for (int c : rows[branchRow]) {
+        if (node.banned[c]) continue;
+        int gain = 0;
+        for (int r : columns[c]) gain += !covered[r];
+        order.push_back({ -gain, c });
+    }
+    sort(order.begin(), order.end());
+
+    for (size_t i = 0; i < order.size(); i++) {
+        int c = order[i].second;
+        node.chosen.push_back(c);
+        bool spawn = false;
+        if (i > 0 && queueCount > 1) {
+            WorkQueue &queue = queues[self];
+            lock_guard<mutex> guard(queue.lock);
+            if (queue.nodes.size() < 2) {
+                pending++;
+                queue.nodes.push_back(node);
+                spawn = true;
+            }
+        }
+        if (!spawn) {
+            for (int r : columns[c]) covered[r]++;
+            search(node, covered, mark, self);
+            for (int r : columns[c]) covered[r]--;
+        }
+        node.chosen.pop_back();
+        node.banned[c] = 1;
+    }
+    for (const auto &candidate : order) node.banned[candidate.second] = 0;
+}
+
+// Uncovered rows that pairwise share no allowed column each need a column
+// of their own
+size_t CoverSearch::lowerBound(const Node &node, const vector<int> &covered, vector<uint8_t> &mark) const {
+    size_t disjoint = 0;
+    vector<int> marked;
+    for (size_t r = 0; r < rows.size(); r++) {
+        if (covered[r]) continue;
+        bool independent = true;
+        for (int c : rows[r])
+            if (!node.banned[c] && mark[c]) { independent = false; break; }
+        if (!independent) continue;
+        disjoint++;
+        for (int c : rows[r]) {
+            if (node.banned[c]) continue;
+            mark[c] = 1;
+            marked.push_back(c);
+        }
+    }
+    for (int c : marked) mark[c] = 0;
+    return disjoint;
+}
+
+void CoverSearch::record(const vector<int> &chosen) {
+    size_t cost = chosen.size();
+    size_t current = best.load();
+    while (cost < current && !best.compare_exchange_weak(current, cost)) {}
+
+    vector<int> cover;
+    for (int c : chosen) cover.push_back(original[c]);
+    sort(cover.begin(), cover.end());
+
+    lock_guard<mutex> guard(resultLock);
+    if (!found.empty() && cost > found[0].size()) return;
+    if (!found.empty() && cost < found[0].size()) found.clear();
+    if (!allCovers && !found.empty()) {
+        if (cover < found[0]) found[0] = cover;
+        return;
+    }
+    found.push_back(cover);
+}
@@ -0,0 +1,69 @@
+// CoverSearch.h
+#ifndef COVERSEARCH_H
+#define COVERSEARCH_H
+
+#include "CancelToken.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Exact minimum-cardinality cover by branch and bound, for cyclic cores too
+// large to expand as a Petrick product. Each node branches on the uncovered
+// row with the fewest candidate columns; branch i takes candidate i and bans
+// candidates 0..i-1, so every cover is reached exactly once. Subtrees are
+// pushed onto per-thread deques (owner pops the back, thieves take the
+// front) and the best cost so far is an atomic every thread prunes against.
+// Only strictly worse nodes are pruned, so the set of co-optimal covers does
+// not depend on scheduling. A stop request ends the search with the best
+// covers found so far.
+class CoverSearch {
+public:
+    // rows[r] lists the columns that cover row r
+    explicit CoverSearch(const vector<vector<int>> &rows);
+    bool allCovers = true; // false keeps only the lexicographically first optimal cover
+    // True when the Petrick product of these rows is expected to blow up
+    static bool preferred(const vector<vector<int>> &rows);
+    // Every cover of minimum size, each sorted, in lexicographic order.
+    // incumbent, if not empty, is a known cover the search has to beat.
+    vector<vector<int>> solve(ThreadPool *pool, const vector<int> &incumbent = {},
+                              const CancelToken *cancel = nullptr);
+    // False when the last solve was stopped before it proved optimality
+    bool complete() const { return !stopped; }
+
+private:
+    struct Node {
+        vector<int> chosen;
+        vector<uint8_t> banned;
+    };
+    struct WorkQueue {
+        mutex lock;
+        deque<Node> nodes;
+    };
+
+    void worker(size_t self);
+    bool takeNode(size_t self, Node &node);
+    void search(Node &node, vector<int> &covered, vector<uint8_t> &mark, size_t self);
+    size_t lowerBound(const Node &node, const vector<int> &covered, vector<uint8_t> &mark) const;
+    void record(const vector<int> &chosen);
+
+    vector<vector<int>> rows;    // local column ids
+    vector<vector<int>> columns; // rows covered by each local column
+    vector<int> original;        // local column id -> caller's column id
+
+    atomic<size_t> best;
+    atomic<size_t> pending;
+    atomic<bool> stopped;
+    const CancelToken *cancel = nullptr;
+    unique_ptr<WorkQueue[]> queues;
+    size_t queueCount = 0;
+    mutex resultLock;
+    vector<vector<int>> found;
+};
+
+#endif // COVERSEARCH_H
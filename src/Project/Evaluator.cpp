@@ -0,0 +1,139 @@
+#include "Evaluator.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EVALUATOR_X86 1
+#endif
+
+using namespace std;
+
+Evaluator::Evaluator(int numVariables, const vector<string> &cover, bool complemented)
+    : numVariables(numVariables), complemented(complemented) {
+    literalStart.push_back(0);
+    for (const auto &cube : cover) {
+        uint32_t cubeBits, cubeDashes;
+        Term::pack(cube, cubeBits, cubeDashes);
+        bits.push_back(cubeBits);
+        care.push_back(((1u << numVariables) - 1) & ~cubeDashes);
+        for (size_t i = 0; i < cube.size(); i++) {
+            if (cube[i] == '1') literals.push_back(uint16_t(i << 1));
+            else if (cube[i] == '0') literals.push_back(uint16_t(i << 1 | 1));
+        }
+        literalStart.push_back(literals.size());
+    }
+}
+
+Evaluator::Evaluator(const MinimizeResult &result, size_t solution)
+    : Evaluator(result.numVariables,
+                solution < result.solutions.size() ? result.solutions[solution] : vector<string>(),
+                result.complemented) {}
+
+bool Evaluator::eval(uint64_t x) const {
+    uint32_t point = uint32_t(x);
+    for (size_t c = 0; c < bits.size(); c++)
+        if (((point ^ bits[c]) & care[c]) == 0) return !complemented;
+    return complemented;
+}
+
+uint64_t Evaluator::eval64(const uint64_t *slices) const {
+    uint64_t result = 0;
+    for (size_t c = 0; c + 1 < literalStart.size() && result != ~uint64_t(0); c++) {
+        uint64_t term = ~uint64_t(0);
+        for (uint32_t l = literalStart[c]; l < literalStart[c + 1] && term; l++) {
+            uint64_t slice = slices[literals[l] >> 1];
+            term &= literals[l] & 1 ? ~slice : slice;
+        }
+        result |= term;
+    }
+    return complemented ? ~result : result;
+}
+
+typedef void (*EvalKernel)(const uint32_t *, const uint16_t *, size_t, const uint64_t *, uint64_t *);
+
+static void eval256Scalar(const uint32_t *literalStart, const uint16_t *literals, size_t cubes,
+                          const uint64_t *slices, uint64_t *out) {
+    uint64_t result[4] = { 0, 0, 0, 0 };
+    for (size_t c = 0; c < cubes; c++) {
+        uint64_t term[4] = { ~uint64_t(0), ~uint64_t(0), ~uint64_t(0), ~uint64_t(0) };
+        for (uint32_t l = literalStart[c]; l < literalStart[c + 1]; l++) {
+            const uint64_t *slice = slices + 4 * (literals[l] >> 1);
+            uint64_t flip = literals[l] & 1 ? ~uint64_t(0) : 0;
+            for (int w = 0; w < 4; w++) term[w] &= slice[w] ^ flip;
+        }
+        for (int w = 0; w < 4; w++) result[w] |= term[w];
+    }
+    for (int w = 0; w < 4; w++) out[w] = result[w];
+}
+
+#ifdef EVALUATOR_X86
+__attribute__((target("avx2")))
+static void eval256AVX2(const uint32_t *literalStart, const uint16_t *literals, size_t cubes,
+                        const uint64_t *slices, uint64_t *out) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    __m256i result = _mm256_setzero_si256();
+    for (size_t c = 0; c < cubes; c++) {
+        __m256i term = ones;
+        for (uint32_t l = literalStart[c]; l < literalStart[c + 1]; l++) {
+            __m256i slice = _mm256_loadu_si256((const __m256i *)(slices + 4 * (literals[l] >> 1)));
+            term = literals[l] & 1 ? _mm256_andnot_si256(slice, term) : _mm256_and_si256(term, slice);
+        }
+        result = _mm256_or_si256(result, term);
+    }
+    _mm256_storeu_si256((__m256i *)out, result);
+}
+#endif
+
+struct EvalDispatch {
+    EvalKernel kernel;
+    const char *name;
+};
+
+static EvalDispatch selectKernel() {
+#ifdef EVALUATOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return { eval256AVX2, "avx2" };
+#endif
+    return { eval256Scalar, "scalar" };
+}
+
+static const EvalDispatch &dispatch() {
+    static const EvalDispatch selected = selectKernel();
+    return selected;
+}
+
+void Evaluator::eval256(const uint64_t *slices, uint64_t *out) const {
+    dispatch().kernel(literalStart.data(), literals.data(), literalStart.size() - 1, slices, out);
+    if (complemented)
+        for (int w = 0; w < 4; w++) out[w] = ~out[w];
+}
+
+const char *Evaluator::kernelName() {
+    return dispatch().name;
+}
+
+uint64_t Evaluator::evalBlock(uint64_t base) const {
+    // Within a block the low six point bits run through every value, so
+    // their slices are fixed patterns; higher bits are constant
+    static const uint64_t pattern[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL,
+    };
+    uint64_t slices[32] = {};
+    for (int i = 0; i < numVariables; i++) {
+        int position = numVariables - 1 - i;
+        slices[i] = position < 6 ? pattern[position] : (base >> position & 1 ? ~uint64_t(0) : 0);
+    }
+    uint64_t result = eval64(slices);
+    if (numVariables < 6) result &= (uint64_t(1) << (1 << numVariables)) - 1;
+    return result;
+}
+
+bool Evaluator::matches(const vector<int> &onSet, const vector<int> &dcSet) const {
+    size_t words = ((size_t(1) << numVariables) + 63) / 64;
+    vector<uint64_t> on(words, 0), dc(words, 0);
+    for (int x : onSet) on[x >> 6] |= uint64_t(1) << (x & 63);
+    for (int x : dcSet) dc[x >> 6] |= uint64_t(1) << (x & 63);
+    for (size_t w = 0; w < words; w++)
+        if ((evalBlock(w * 64) ^ on[w]) & ~dc[w]) return false;
+    return true;
+}
@@ -0,0 +1,50 @@
+// Evaluator.h
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "Minimizer.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Evaluates a minimized cover in software. eval() tests one point against
+// the packed cube masks; the sliced forms take 64 or 256 points at once,
+// one machine word per variable, and compute F with AND/OR over the words
+// (bit-slicing), so a simulator pays a few instructions per literal for a
+// whole batch.
+class Evaluator {
+public:
+    // cover: cubes over {0,1,-}, variable A first. complemented evaluates
+    // the complement of the cover, as for a dual-phase result won by F'.
+    Evaluator(int numVariables, const vector<string> &cover, bool complemented = false);
+    explicit Evaluator(const MinimizeResult &result, size_t solution = 0);
+
+    // F at one point, numbered like minterms (bit numVariables-1 is A)
+    bool eval(uint64_t x) const;
+    // slices[i] holds variable i (0 is A) of 64 points, point k in bit k;
+    // bit k of the result is F of point k
+    uint64_t eval64(const uint64_t *slices) const;
+    // 256 points: slices[4 * i .. 4 * i + 3] hold variable i, and out[w]
+    // bit k is F of point 64 * w + k. Uses AVX2 when the CPU has it.
+    void eval256(const uint64_t *slices, uint64_t *out) const;
+    // F of the points base .. base + 63 (base a multiple of 64); bits for
+    // points past 2^numVariables are 0
+    uint64_t evalBlock(uint64_t base) const;
+    // True when the cover is 1 on every point of onSet and 0 on every point
+    // that is in neither set
+    bool matches(const vector<int> &onSet, const vector<int> &dcSet) const;
+
+    // Name of the kernel eval256 dispatches to ("avx2", "scalar")
+    static const char *kernelName();
+
+private:
+    int numVariables;
+    bool complemented;
+    vector<uint32_t> bits, care;   // per cube; a point x is inside when ((x ^ bits) & care) == 0
+    vector<uint32_t> literalStart; // cube c's literals are literals[literalStart[c] .. literalStart[c + 1]]
+    vector<uint16_t> literals;     // variable index << 1, | 1 for a complemented literal
+};
+
+#endif // EVALUATOR_H
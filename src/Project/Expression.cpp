@@ -7,19 +7,44 @@
 
 using namespace std;
 
-Expression::Expression(const string &filename) {
+Expression::Expression() : numVariables(0) {}
+
+Expression::Expression(const string &filename) : numVariables(0) {
     ifstream file(filename);
     if (!file) {
         cerr << "Error: Unable to open file." << endl;
         exit(1);
     }
-    readInputFile(file);
+    Status status = readInput(file);
+    if (status == Status::AlwaysOne) {
+        cerr << "The function has all of the input as either minterms or don't cares, so it will always result in 1. Just connect wires instead" << endl;
+        exit(1);
+    }
+    if (status != Status::Ok) {
+        cerr << "Error: " << error << endl;
+        exit(1);
+    }
+}
+
+Status Expression::fail(Status status, const string &message) {
+    error = message;
+    return status;
+}
+
+bool Expression::parseNumber(const string &token, int &value) {
+    size_t end = 0;
+    try {
+        value = stoi(token, &end);
+    } catch (const exception &) {
+        return false;
+    }
+    // Allow the trailing whitespace/carriage return left over from the line
+    return token.find_first_not_of(" \t\r\n", end) == string::npos;
 }
 
-void Expression::readInputFile(ifstream &file) {
+Status Expression::readInput(istream &file) {
     if (!(file >> numVariables) || numVariables < 1 || numVariables > 20) {
-        cerr << "Error: Invalid number of variables." << endl;
-        exit(1);
+        return fail(Status::InvalidVariableCount, "Invalid number of variables.");
     }
 
     string minMaxTerms, dontCareTerms;
@@ -27,14 +52,27 @@ void Expression::readInputFile(ifstream &file) {
     getline(file, minMaxTerms);
     getline(file, dontCareTerms);
 
-    checkForConflicts(minMaxTerms, dontCareTerms);
+    Status status = checkForConflicts(minMaxTerms, dontCareTerms);
+    if (status != Status::Ok) return status;
 
-    termType = determineTermType(minMaxTerms);
+    status = determineTermType(minMaxTerms);
+    if (status != Status::Ok) return status;
     
     // Parse terms
     vector<Term> terms;
-    parseTerms(minMaxTerms, termType == "minterms" ? 'm' : 'M', terms);
-    parseTerms(dontCareTerms, 'd', dontCares);
+    status = parseTerms(minMaxTerms, termType == "minterms" ? 'm' : 'M', terms);
+    if (status != Status::Ok) return status;
+    status = parseTerms(dontCareTerms, 'd', dontCares);
+    if (status != Status::Ok) return status;
+    status = parseCubes(minMaxTerms, onCubes);
+    if (status != Status::Ok) return status;
+    status = parseCubes(dontCareTerms, dcCubes);
+    if (status != Status::Ok) return status;
+    if (termType == "maxterms" && !onCubes.empty()) {
+        return fail(Status::MixedTermTypes, "Cubes give on-set terms and cannot be mixed with maxterms.");
+    }
+    status = expandCubes(terms);
+    if (status != Status::Ok) return status;
     
     // If we have maxterms, convert to minterms
     if (termType == "maxterms") {
@@ -44,11 +82,41 @@ void Expression::readInputFile(ifstream &file) {
         minterms = terms;
     }
     
-    validateTermCount();
+    return validateTermCount();
 }
 
+Status Expression::readInput(int numVariables, const vector<int> &onSet, const vector<int> &dcSet) {
+    if (numVariables < 1 || numVariables > 20) {
+        return fail(Status::InvalidVariableCount, "Invalid number of variables.");
+    }
+    this->numVariables = numVariables;
+    termType = "minterms";
 
-void Expression::checkForConflicts(const string &minMaxTerms, const string &dontCareTerms) {
+    int limit = 1 << numVariables;
+    set<int> termValues;
+    for (int value : onSet) {
+        if (value < 0 || value >= limit) {
+            return fail(Status::InvalidTerm, "Invalid term value: " + to_string(value));
+        }
+        if (termValues.insert(value).second)
+            minterms.emplace_back(value, numVariables);
+    }
+    set<int> dcValues;
+    for (int value : dcSet) {
+        if (value < 0 || value >= limit) {
+            return fail(Status::InvalidTerm, "Invalid term value: " + to_string(value));
+        }
+        if (termValues.count(value)) {
+            return fail(Status::TermConflict, "Term " + to_string(value) + " is both a minterm and a don't care.");
+        }
+        if (dcValues.insert(value).second)
+            dontCares.emplace_back(value, numVariables);
+    }
+    return validateTermCount();
+}
+
+
+Status Expression::checkForConflicts(const string &minMaxTerms, const string &dontCareTerms) {
     // Check for mixed term types (both 'm' and 'M')
     bool hasMinterm = false;
     bool hasMaxterm = false;
@@ -60,20 +128,21 @@ void Expression::checkForConflicts(const string &minMaxTerms, const string &dont
     
     while (getline(ss1, token, ',')) {
         token.erase(0, token.find_first_not_of(" "));
+        if (isCube(token)) continue; // checked by expandCubes
         if (token.size() > 1) {
             if (token[0] == 'm') hasMinterm = true;
             if (token[0] == 'M') hasMaxterm = true;
             
-            if (token.size() > 1) {
-                int value = stoi(token.substr(1));
-                termValues.insert(value);
+            int value;
+            if (!parseNumber(token.substr(1), value)) {
+                return fail(Status::InvalidTerm, "Invalid term: " + token);
             }
+            termValues.insert(value);
         }
     }
     
     if (hasMinterm && hasMaxterm) {
-        cerr << "Error: Mixed term types (both minterms and maxterms) are not allowed." << endl;
-        exit(1);
+        return fail(Status::MixedTermTypes, "Mixed term types (both minterms and maxterms) are not allowed.");
     }
     
     // Check for conflicts between terms and don't cares
@@ -81,38 +150,40 @@ void Expression::checkForConflicts(const string &minMaxTerms, const string &dont
     while (getline(ss2, token, ',')) {
         token.erase(0, token.find_first_not_of(" "));
         if (token.size() > 1 && token[0] == 'd') {
-            int value = stoi(token.substr(1));
+            int value;
+            if (!parseNumber(token.substr(1), value)) {
+                return fail(Status::InvalidTerm, "Invalid term: " + token);
+            }
             if (termValues.find(value) != termValues.end()) {
-                cerr << "Error: Term " << value << " is both a " 
-                     << (hasMinterm ? "minterm" : "maxterm") 
-                     << " and a don't care." << endl;
-                exit(1);
+                return fail(Status::TermConflict, "Term " + to_string(value) + " is both a "
+                     + (hasMinterm ? "minterm" : "maxterm") + " and a don't care.");
             }
         }
     }
+    return Status::Ok;
 }
 
-string Expression::determineTermType(const string &terms) {
+Status Expression::determineTermType(const string &terms) {
     stringstream ss(terms);
     string token;
     bool hasTerms = false;
     
     while (getline(ss, token, ',')) {
         token.erase(0, token.find_first_not_of(" "));
-        if (!token.empty()) {
+        if (!token.empty() && !isCube(token)) {
             hasTerms = true;
-            if (token[0] == 'm') return "minterms";
-            if (token[0] == 'M') return "maxterms";
+            if (token[0] == 'm') { termType = "minterms"; return Status::Ok; }
+            if (token[0] == 'M') { termType = "maxterms"; return Status::Ok; }
         }
     }
     
     // If we have an empty terms list (only don't cares or no inputs at all)
     if (!hasTerms) {
-        return "minterms"; // Default to minterms when only don't cares are present
+        termType = "minterms"; // Default to minterms when only don't cares are present
+        return Status::Ok;
     }
     
-    cerr << "Error: Could not determine term type." << endl;
-    exit(1);
+    return fail(Status::UnknownTermType, "Could not determine term type.");
 }
 
 
@@ -140,33 +211,103 @@ void Expression::convertMaxtermsToMinterms(const vector<Term> &maxterms) {
 }
 
 
-void Expression::parseTerms(const string &terms, char prefix, vector<Term> &termList) {
+Status Expression::parseTerms(const string &terms, char prefix, vector<Term> &termList) {
     stringstream ss(terms);
     string token;
     while (getline(ss, token, ',')) {
         token.erase(0, token.find_first_not_of(" "));
         if (token.size() > 1 && token[0] == prefix) {
-            int num = stoi(token.substr(1));
+            int num;
+            if (!parseNumber(token.substr(1), num)) {
+                return fail(Status::InvalidTerm, "Invalid term: " + token);
+            }
             if (num < 0 || num >= pow(2, numVariables)) {
-                cerr << "Error: Invalid term value: " << num << endl;
-                exit(1);
+                return fail(Status::InvalidTerm, "Invalid term value: " + to_string(num));
             }
             termList.emplace_back(num, numVariables);
         }
     }
+    return Status::Ok;
 }
 
-void Expression::validateTermCount() {
+bool Expression::isCube(const string &token) {
+    return !token.empty() && (token[0] == '0' || token[0] == '1' || token[0] == '-');
+}
+
+Status Expression::parseCubes(const string &terms, vector<string> &cubeList) {
+    stringstream ss(terms);
+    string token;
+    while (getline(ss, token, ',')) {
+        token.erase(0, token.find_first_not_of(" "));
+        if (!isCube(token)) continue;
+        token.erase(token.find_last_not_of(" \t\r\n") + 1);
+        if (int(token.size()) != numVariables || token.find_first_not_of("01-") != string::npos) {
+            return fail(Status::InvalidTerm, "Invalid cube: " + token);
+        }
+        cubeList.push_back(token);
+    }
+    return Status::Ok;
+}
+
+// Conflicts are found between whole cubes first, so two overlapping cubes
+// are reported as such; the points of the cubes are then added to terms
+// (on-set) and dontCares, skipping points already listed
+Status Expression::expandCubes(vector<Term> &terms) {
+    if (onCubes.empty() && dcCubes.empty()) return Status::Ok;
+    for (const auto &on : onCubes) {
+        uint32_t onBits, onDashes;
+        Term::pack(on, onBits, onDashes);
+        for (const auto &dc : dcCubes) {
+            uint32_t dcBits, dcDashes;
+            Term::pack(dc, dcBits, dcDashes);
+            if (((onBits ^ dcBits) & ~(onDashes | dcDashes)) == 0) {
+                return fail(Status::TermConflict, "Cube " + on + " overlaps don't care cube " + dc + ".");
+            }
+        }
+    }
+
+    // 1 = listed on/off term, 2 = don't care
+    vector<uint8_t> state(size_t(1) << numVariables, 0);
+    for (const auto &term : terms) state[term.value] = 1;
+    for (const auto &term : dontCares) state[term.value] = 2;
+    auto addPoints = [&](const string &cube, uint8_t mark, vector<Term> &list) {
+        uint32_t bits, dashes;
+        Term::pack(cube, bits, dashes);
+        uint32_t sub = 0;
+        do {
+            uint32_t x = bits | sub;
+            if (state[x] == 3 - mark) {
+                return fail(Status::TermConflict, "Term " + to_string(x) + " is inside cube " + cube +
+                                                      (mark == 1 ? " and is a don't care." : " and is also listed as a term."));
+            }
+            if (state[x] == 0) {
+                state[x] = mark;
+                list.emplace_back(int(x), numVariables);
+            }
+            sub = (sub - dashes) & dashes;
+        } while (sub != 0);
+        return Status::Ok;
+    };
+    for (const auto &cube : dcCubes) {
+        Status status = addPoints(cube, 2, dontCares);
+        if (status != Status::Ok) return status;
+    }
+    for (const auto &cube : onCubes) {
+        Status status = addPoints(cube, 1, terms);
+        if (status != Status::Ok) return status;
+    }
+    return Status::Ok;
+}
+
+Status Expression::validateTermCount() {
     int totalTerms = minterms.size() + dontCares.size();
     if (totalTerms < 0 || totalTerms > (pow(2, numVariables))) {
-        cerr << "Error: Invalid number of terms." << endl;
-        exit(1);
+        return fail(Status::InvalidTermCount, "Invalid number of terms.");
     }
     else if (totalTerms == (pow(2, numVariables))) {
-        cerr << "The function has all of the input as either minterms or don't cares, so it will always result in 1. Just connect wires instead" << endl;
-        exit(1);
+        return fail(Status::AlwaysOne, "The function is always 1.");
     }
-
+    return Status::Ok;
 }
 
 void Expression::printTerms() {
@@ -198,6 +339,3 @@ void Expression::printTerms() {
     for (const auto &term : dontCares) cout << term.value << " ";
     cout << endl;
 }
-
-
-
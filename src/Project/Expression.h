@@ -2,9 +2,11 @@
 #define EXPRESSION_H
 
 #include "Term.h"
+#include "Status.h"
 #include <vector>
 #include <string>
 #include <set>
+#include <istream>
 
 using namespace std;
 
@@ -14,16 +16,30 @@ public:
     vector<Term> minterms;
     vector<Term> maxterms;
     vector<Term> dontCares;
+    // Cubes such as 1-0- given on the m and d lines (variable A first); their
+    // points are in minterms/dontCares as well
+    vector<string> onCubes;
+    vector<string> dcCubes;
     string termType;
-    
-    Expression(const string &filename);
-    void readInputFile(ifstream &file);
-    string determineTermType(const string &terms);
-    void parseTerms(const string &terms, char prefix, vector<Term> &termList);
+    string error; // message for the last failed check
+
+    Expression();
+    Expression(const string &filename); // command line use: exits on any error
+    Status readInput(istream &file);
+    Status readInput(int numVariables, const vector<int> &onSet, const vector<int> &dcSet);
+    Status determineTermType(const string &terms);
+    Status parseTerms(const string &terms, char prefix, vector<Term> &termList);
+    Status parseCubes(const string &terms, vector<string> &cubeList);
+    Status expandCubes(vector<Term> &terms);
     void convertMaxtermsToMinterms(const vector<Term> &maxterms);
-    void validateTermCount();
+    Status validateTermCount();
     void printTerms();
-    void checkForConflicts(const string &minMaxTerms, const string &dontCareTerms);
+    Status checkForConflicts(const string &minMaxTerms, const string &dontCareTerms);
+
+private:
+    Status fail(Status status, const string &message);
+    static bool parseNumber(const string &token, int &value);
+    static bool isCube(const string &token);
 
 };
 
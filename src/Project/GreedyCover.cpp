@@ -0,0 +1,70 @@
+#include "GreedyCover.h"
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <utility>
+
+using namespace std;
+
+bool GreedyCover::preferred(const vector<vector<int>> &rows) {
+    // Cyclic blocks of ~60 rows already take the exact search seconds, and
+    // the effort roughly doubles with every few rows beyond that
+    return rows.size() > 96;
+}
+
+vector<int> GreedyCover::solve(const vector<vector<int>> &rows) {
+    // Dense column ids so the bookkeeping is plain arrays
+    vector<int> ids;
+    for (const auto &row : rows) ids.insert(ids.end(), row.begin(), row.end());
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    vector<vector<int>> columns(ids.size());
+    for (size_t r = 0; r < rows.size(); r++)
+        for (int c : rows[r])
+            columns[lower_bound(ids.begin(), ids.end(), c) - ids.begin()].push_back(r);
+
+    // Heap entries are (gain, -column) so ties pop the lower column first
+    priority_queue<pair<int, int>> heap;
+    for (size_t c = 0; c < columns.size(); c++)
+        heap.push({ int(columns[c].size()), -int(c) });
+
+    vector<uint8_t> covered(rows.size(), 0);
+    vector<int> picked;
+    size_t open = rows.size();
+    while (open > 0 && !heap.empty()) {
+        auto [gain, negColumn] = heap.top();
+        heap.pop();
+        int c = -negColumn;
+        int fresh = 0;
+        for (int r : columns[c]) fresh += !covered[r];
+        if (fresh < gain) {
+            if (fresh > 0) heap.push({ fresh, negColumn });
+            continue;
+        }
+        picked.push_back(c);
+        for (int r : columns[c]) {
+            if (covered[r]) continue;
+            covered[r] = 1;
+            open--;
+        }
+    }
+
+    // Redundancy removal: late picks covered the fewest new rows, so they
+    // are the likeliest to be fully covered by the rest
+    vector<int> coverCount(rows.size(), 0);
+    for (int c : picked)
+        for (int r : columns[c]) coverCount[r]++;
+    vector<uint8_t> dropped(picked.size(), 0);
+    for (size_t i = picked.size(); i-- > 0;) {
+        const vector<int> &rowsOf = columns[picked[i]];
+        bool redundant = all_of(rowsOf.begin(), rowsOf.end(), [&](int r) { return coverCount[r] > 1; });
+        if (!redundant) continue;
+        dropped[i] = 1;
+        for (int r : rowsOf) coverCount[r]--;
+    }
+
+    vector<int> cover;
+    for (size_t i = 0; i < picked.size(); i++)
+        if (!dropped[i]) cover.push_back(ids[picked[i]]);
+    return cover;
+}
@@ -0,0 +1,24 @@
+// GreedyCover.h
+#ifndef GREEDYCOVER_H
+#define GREEDYCOVER_H
+
+#include <vector>
+
+using namespace std;
+
+// Approximate set cover in near-linear time. Columns sit in a max-heap keyed
+// by how many open rows they cover; a column's key is only refreshed when it
+// reaches the top (gains never grow, so a stale key is an upper bound and the
+// first fresh top is the true best). Afterwards columns are dropped, last
+// picked first, while every row they cover is covered again elsewhere.
+class GreedyCover {
+public:
+    // rows[r] lists the columns that cover row r; returns the chosen columns
+    // in the order they were picked. Ties go to the lower column id.
+    static vector<int> solve(const vector<vector<int>> &rows);
+    // True when the cover table is too large for an exact search to be
+    // expected to finish
+    static bool preferred(const vector<vector<int>> &rows);
+};
+
+#endif // GREEDYCOVER_H
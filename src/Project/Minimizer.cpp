@@ -0,0 +1,410 @@
+#include "Minimizer.h"
+#include "Approximation.h"
+#include "PrimeUpdate.h"
+#include "ShannonSplit.h"
+#include "Symmetry.h"
+#include "Trace.h"
+#include "ZddCover.h"
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <ostream>
+
+using namespace std;
+
+static Status failed(const Expression &expression, Status status, MinimizeResult &result) {
+    result.status = status;
+    result.error = expression.error;
+    result.numVariables = expression.numVariables;
+    if (status == Status::AlwaysOne) {
+        // Still a usable answer: a single cube with every variable free
+        result.solutions.push_back({ string(expression.numVariables, '-') });
+        result.expressions.push_back("1");
+    }
+    return status;
+}
+
+// Shared by every caller; runAll lets a call that is itself running on a
+// pool thread help with its own blocks instead of waiting on them
+static ThreadPool &solverPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+static string coverExpression(const vector<string> &cover, int numVariables) {
+    string expr;
+    for (const auto &cube : cover) {
+        Term term(0, numVariables);
+        term.binary = cube;
+        if (!expr.empty()) expr += " + ";
+        expr += term.toExpression();
+    }
+    return expr;
+}
+
+// Shannon mode: the cofactors are minimized concurrently, one cover each,
+// and ShannonSplit::merge turns their union into a cover of the function
+static Status minimizeSplit(const Expression &expression, MinimizeResult &result,
+                            const MinimizeOptions &options) {
+    int n = expression.numVariables;
+    vector<int> onSet, dcSet;
+    for (const auto &term : expression.minterms) onSet.push_back(term.value);
+    for (const auto &term : expression.dontCares) dcSet.push_back(term.value);
+    ShannonSplit splitter(n, onSet, dcSet);
+    vector<ShannonSplit::Cofactor> cofactors = splitter.split(options.splitDepth);
+
+    MinimizeOptions leafOptions = options;
+    leafOptions.shannonSplit = false;
+    if (cofactors.size() == 1) return minimize(expression, result, leafOptions);
+
+    // The cofactors share one deadline rather than getting one each
+    CancelToken deadline(options.cancel);
+    if (options.timeLimitMs > 0) deadline.setTimeLimit(chrono::milliseconds(options.timeLimitMs));
+    leafOptions.allSolutions = false;
+    leafOptions.timeLimitMs = 0;
+    if (options.timeLimitMs > 0 || options.cancel) leafOptions.cancel = &deadline;
+
+    vector<MinimizeResult> parts(cofactors.size());
+    vector<function<void()>> jobs;
+    for (size_t i = 0; i < cofactors.size(); i++) {
+        if (cofactors[i].onSet.empty()) continue;
+        jobs.push_back([&, i] {
+            minimize(n, cofactors[i].onSet, cofactors[i].dcSet, parts[i], leafOptions);
+        });
+    }
+    if (options.parallel) {
+        solverPool().runAll(jobs);
+    } else {
+        for (auto &job : jobs) job();
+    }
+
+    vector<string> cubes;
+    for (const auto &part : parts)
+        if (!part.solutions.empty())
+            cubes.insert(cubes.end(), part.solutions[0].begin(), part.solutions[0].end());
+
+    result = MinimizeResult();
+    result.numVariables = n;
+    result.exact = false; // the merged cover is irredundant, not proven minimal
+    result.onSet = onSet;
+    result.dcSet = dcSet;
+    vector<string> cover = splitter.merge(cubes, result.primeImplicants);
+    result.primeCount = result.primeImplicants.size();
+    result.solutions.push_back(cover);
+    result.expressions.push_back(coverExpression(cover, n));
+    return result.status;
+}
+
+// Gate inputs of the two-level circuit: one per literal of every product
+// with more than one literal, plus one per product into the output gate.
+// The product of sums built from a cover of F' has the same count.
+static size_t coverCost(const vector<string> &cover) {
+    size_t cost = cover.size() > 1 ? cover.size() : 0;
+    for (const auto &cube : cover) {
+        size_t literals = cube.size() - count(cube.begin(), cube.end(), '-');
+        if (literals > 1) cost += literals;
+    }
+    return cost;
+}
+
+// Dual phase: F from its on-set and F' from its off-set with the same
+// don't-cares, minimized side by side; ties go to the sum of products
+static Status minimizeDual(const Expression &expression, MinimizeResult &result,
+                           const MinimizeOptions &options) {
+    int n = expression.numVariables;
+    vector<uint8_t> inF(size_t(1) << n, 0);
+    vector<int> offSet, dcSet;
+    for (const auto &term : expression.minterms) inF[term.value] = 1;
+    for (const auto &term : expression.dontCares) {
+        inF[term.value] = 1;
+        dcSet.push_back(term.value);
+    }
+    for (size_t x = 0; x < inF.size(); x++)
+        if (!inF[x]) offSet.push_back(int(x));
+
+    MinimizeOptions phaseOptions = options;
+    phaseOptions.dualPhase = false;
+    MinimizeResult complement;
+    Status complementStatus = Status::Ok;
+    vector<function<void()>> jobs = {
+        [&] { minimize(expression, result, phaseOptions); },
+        [&] { complementStatus = minimize(n, offSet, dcSet, complement, phaseOptions); },
+    };
+    if (options.parallel) {
+        solverPool().runAll(jobs);
+    } else {
+        for (auto &job : jobs) job();
+    }
+
+    // F' always one means F has no on-set: the plain result already says so
+    if (result.status != Status::Ok || complementStatus != Status::Ok || complement.solutions.empty() ||
+        result.solutions.empty() || coverCost(complement.solutions[0]) >= coverCost(result.solutions[0]))
+        return result.status;
+
+    complement.complemented = true;
+    complement.expressions.clear();
+    for (const auto &cover : complement.solutions) {
+        string expr;
+        for (const auto &cube : cover) {
+            Term term(0, n);
+            term.binary = cube;
+            expr += term.toSum();
+        }
+        complement.expressions.push_back(expr);
+    }
+    // Keep describing F, so reminimize edits the right function; its primes
+    // are those of F', so an edit starts over
+    complement.onSet = result.onSet;
+    complement.dcSet = result.dcSet;
+    complement.allPrimes = false;
+    result = move(complement);
+    return result.status;
+}
+
+// Symmetry mode: primes are grown one per orbit and expanded, and the cover
+// search keeps one cover per orbit; without symmetric inputs it is the
+// plain minimize
+static Status minimizeSymmetric(const Expression &expression, MinimizeResult &result,
+                                const MinimizeOptions &options) {
+    int n = expression.numVariables;
+    vector<int> onSet, dcSet;
+    for (const auto &term : expression.minterms) onSet.push_back(term.value);
+    for (const auto &term : expression.dontCares) dcSet.push_back(term.value);
+    MinimizeOptions plainOptions = options;
+    plainOptions.symmetry = false;
+    Symmetry symmetry(n, onSet, dcSet);
+    if (symmetry.groups.empty()) return minimize(expression, result, plainOptions);
+
+    CancelToken deadline(options.cancel);
+    if (options.timeLimitMs > 0) deadline.setTimeLimit(chrono::milliseconds(options.timeLimitMs));
+    const CancelToken *cancel = options.timeLimitMs > 0 || options.cancel ? &deadline : nullptr;
+
+    result = MinimizeResult();
+    result.numVariables = n;
+    result.symmetricGroups = symmetry.groups;
+    result.onSet = onSet;
+    result.dcSet = dcSet;
+    vector<string> representatives = symmetry.representativePrimes(cancel);
+    result.representativePrimes = representatives.size();
+    result.primeImplicants = symmetry.expand(representatives);
+    result.primeCount = result.primeImplicants.size();
+    result.allPrimes = !(cancel && cancel->stopRequested());
+    size_t maxSolutions = options.allSolutions ? options.maxSolutions : 1;
+    result.solutions = symmetry.covers(result.primeImplicants, maxSolutions,
+                                       options.parallel ? &solverPool() : nullptr, cancel, result.exact);
+    result.exact = result.exact && result.allPrimes;
+    for (const auto &cover : result.solutions) result.expressions.push_back(coverExpression(cover, n));
+    return result.status;
+}
+
+// Approximate mode, one change at a time: the most promising changes of the
+// current cover are tried by minimizing again with their points as
+// don't-cares, and the first one that lowers the cost while the points the
+// new cover really gets wrong stay within budget is kept
+static Status minimizeApproximate(const Expression &expression, MinimizeResult &result,
+                                  const MinimizeOptions &options) {
+    int n = expression.numVariables;
+    CancelToken deadline(options.cancel);
+    if (options.timeLimitMs > 0) deadline.setTimeLimit(chrono::milliseconds(options.timeLimitMs));
+    MinimizeOptions exactOptions = options;
+    exactOptions.maxErrorPoints = 0;
+    exactOptions.maxErrorProbability = 0;
+    exactOptions.dualPhase = false; // errors are counted on covers of F
+    exactOptions.allSolutions = false;
+    exactOptions.timeLimitMs = 0;
+    if (options.timeLimitMs > 0 || options.cancel) exactOptions.cancel = &deadline;
+    if (minimize(expression, result, exactOptions) != Status::Ok || result.solutions.empty())
+        return result.status;
+
+    Approximation approximation(n, result.onSet, result.dcSet, options.pointProbability);
+    result.exactCost = result.cost = coverCost(result.solutions[0]);
+    auto overBudget = [&](size_t points, double probability) {
+        return (options.maxErrorPoints > 0 && points > options.maxErrorPoints) ||
+               (options.maxErrorProbability > 0 && probability > options.maxErrorProbability);
+    };
+
+    const size_t triesPerRound = 8;
+    for (bool improved = true; improved && !deadline.stopRequested();) {
+        improved = false;
+        size_t tries = 0;
+        sort(result.onSet.begin(), result.onSet.end());
+        sort(result.dcSet.begin(), result.dcSet.end());
+        for (auto &change : approximation.candidates(result.solutions[0], result.onSet, result.dcSet)) {
+            // Counted as if every point of the change went wrong
+            if (overBudget(result.errorPoints.size() + change.points.size(), result.errorProbability + change.error))
+                continue;
+            if (tries++ == triesPerRound || deadline.stopRequested()) break;
+
+            sort(change.points.begin(), change.points.end());
+            vector<int> onSet, dcSet;
+            set_difference(result.onSet.begin(), result.onSet.end(), change.points.begin(), change.points.end(),
+                           back_inserter(onSet));
+            set_union(result.dcSet.begin(), result.dcSet.end(), change.points.begin(), change.points.end(),
+                      back_inserter(dcSet));
+            MinimizeResult trial;
+            if (minimize(n, onSet, dcSet, trial, exactOptions) != Status::Ok || trial.solutions.empty()) continue;
+            size_t cost = coverCost(trial.solutions[0]);
+            if (cost >= result.cost) continue;
+            vector<int> wrong = approximation.errors(trial.solutions[0]);
+            double probability = 0;
+            for (int x : wrong) probability += approximation.weight(x);
+            if (overBudget(wrong.size(), probability)) continue;
+
+            trial.exactCost = result.exactCost;
+            trial.cost = cost;
+            trial.errorPoints = move(wrong);
+            trial.errorProbability = probability;
+            result = move(trial);
+            improved = true;
+            break;
+        }
+    }
+    return result.status;
+}
+
+// PIEngine::Zdd: primes and Petrick's product are kept as decision diagrams
+// and only the minimum covers are written out as cubes
+static Status minimizeImplicit(const Expression &expression, MinimizeResult &result,
+                               const MinimizeOptions &options) {
+    int n = expression.numVariables;
+    result = MinimizeResult();
+    result.numVariables = n;
+    for (const auto &term : expression.minterms) result.onSet.push_back(term.value);
+    for (const auto &term : expression.dontCares) result.dcSet.push_back(term.value);
+
+    CancelToken deadline(options.cancel);
+    if (options.timeLimitMs > 0) deadline.setTimeLimit(chrono::milliseconds(options.timeLimitMs));
+    const CancelToken *cancel = options.timeLimitMs > 0 || options.cancel ? &deadline : nullptr;
+
+    ZddCover implicit(n, result.onSet, result.dcSet);
+    result.primeCount = implicit.primeCount();
+    result.solutions = implicit.covers(options.allSolutions ? options.maxSolutions : 1,
+                                       options.parallel ? &solverPool() : nullptr, cancel, result.exact);
+    for (const auto &cover : result.solutions) result.expressions.push_back(coverExpression(cover, n));
+    return result.status;
+}
+
+Status minimize(const Expression &expression, MinimizeResult &result, const MinimizeOptions &options) {
+    TraceSpan span("minimize", expression.numVariables);
+    if (options.maxErrorPoints > 0 || options.maxErrorProbability > 0)
+        return minimizeApproximate(expression, result, options);
+    if (options.dualPhase) return minimizeDual(expression, result, options);
+    if (options.shannonSplit) return minimizeSplit(expression, result, options);
+    if (options.symmetry) return minimizeSymmetric(expression, result, options);
+    if (options.piEngine == PIEngine::Zdd) return minimizeImplicit(expression, result, options);
+    result = MinimizeResult();
+    result.numVariables = expression.numVariables;
+
+    // One Table per thread, reset between calls, so a batch of calls reuses
+    // its merge buffers. A stream without a buffer swallows the progress log.
+    thread_local ostream quiet(nullptr);
+    thread_local Table table(quiet);
+    table.reset();
+    table.piEngine = options.piEngine;
+    table.memoryBudget = options.memoryBudget;
+    table.spillDirectory = options.spillDirectory;
+    table.coverEngine = options.coverEngine;
+    table.allSolutions = options.allSolutions;
+    table.pool = options.parallel ? &solverPool() : nullptr;
+    CancelToken deadline(options.cancel);
+    if (options.timeLimitMs > 0) deadline.setTimeLimit(chrono::milliseconds(options.timeLimitMs));
+    table.cancel = options.timeLimitMs > 0 || options.cancel ? &deadline : nullptr;
+    vector<string> cubes = expression.onCubes;
+    cubes.insert(cubes.end(), expression.dcCubes.begin(), expression.dcCubes.end());
+    table.load(expression.minterms, expression.dontCares, cubes);
+    table.generatePrimeImplicants();
+    result.allPrimes = table.exact;
+    table.EPIgeneration();
+    table.cancel = nullptr;
+    result.exact = table.exact;
+    for (const auto &term : expression.minterms) result.onSet.push_back(term.value);
+    for (const auto &term : expression.dontCares) result.dcSet.push_back(term.value);
+
+    for (const auto &pi : table.primeImplicants)
+        result.primeImplicants.push_back(pi.binary);
+    result.primeCount = result.primeImplicants.size();
+
+    for (const auto &solution : table.solutions) {
+        vector<string> cubes;
+        string expr;
+        for (auto p : solution) {
+            const Term &pi = table.primeImplicants[p];
+            cubes.push_back(pi.binary);
+            if (!expr.empty()) expr += " + ";
+            expr += pi.toExpression();
+        }
+        result.solutions.push_back(cubes);
+        result.expressions.push_back(expr);
+        if (!options.allSolutions) break;
+    }
+    return result.status;
+}
+
+Status minimize(int numVariables, const vector<int> &onSet, const vector<int> &dcSet,
+                MinimizeResult &result, const MinimizeOptions &options) {
+    Expression expression;
+    Status status = expression.readInput(numVariables, onSet, dcSet);
+    if (status != Status::Ok) {
+        result = MinimizeResult();
+        return failed(expression, status, result);
+    }
+    return minimize(expression, result, options);
+}
+
+Status minimize(const string &spec, MinimizeResult &result, const MinimizeOptions &options) {
+    Expression expression;
+    istringstream in(spec);
+    Status status = expression.readInput(in);
+    if (status != Status::Ok) {
+        result = MinimizeResult();
+        return failed(expression, status, result);
+    }
+    return minimize(expression, result, options);
+}
+
+static vector<int> applyEdit(vector<int> points, const vector<int> &add, const vector<int> &remove) {
+    points.insert(points.end(), add.begin(), add.end());
+    sort(points.begin(), points.end());
+    points.erase(unique(points.begin(), points.end()), points.end());
+    vector<int> gone = remove;
+    sort(gone.begin(), gone.end());
+    vector<int> kept;
+    set_difference(points.begin(), points.end(), gone.begin(), gone.end(), back_inserter(kept));
+    return kept;
+}
+
+Status reminimize(const MinimizeResult &previous, const SpecDelta &delta, MinimizeResult &result,
+                  const MinimizeOptions &options) {
+    int n = previous.numVariables;
+    vector<int> onSet = applyEdit(previous.onSet, delta.addOn, delta.removeOn);
+    vector<int> dcSet = applyEdit(previous.dcSet, delta.addDc, delta.removeDc);
+    Expression expression;
+    Status status = expression.readInput(n, onSet, dcSet);
+    if (status != Status::Ok) {
+        result = MinimizeResult();
+        return failed(expression, status, result);
+    }
+    if (previous.status != Status::Ok || !previous.allPrimes || previous.solutions.empty() ||
+        options.shannonSplit)
+        return minimize(expression, result, options);
+
+    CancelToken deadline(options.cancel);
+    if (options.timeLimitMs > 0) deadline.setTimeLimit(chrono::milliseconds(options.timeLimitMs));
+    PrimeUpdate update(n, previous.onSet, previous.dcSet, onSet, dcSet);
+    vector<string> primes = update.updatePrimes(previous.primeImplicants);
+    vector<string> cover = update.updateCover(previous.solutions[0],
+                                              options.parallel ? &solverPool() : nullptr,
+                                              options.timeLimitMs > 0 || options.cancel ? &deadline : nullptr);
+
+    result = MinimizeResult();
+    result.numVariables = n;
+    result.exact = false; // the untouched part of the old cover is kept as is
+    result.allPrimes = true;
+    result.primeImplicants = primes;
+    result.primeCount = primes.size();
+    result.solutions.push_back(cover);
+    result.expressions.push_back(coverExpression(cover, n));
+    result.onSet = onSet;
+    result.dcSet = dcSet;
+    return result.status;
+}
@@ -0,0 +1,102 @@
+// Minimizer.h
+#ifndef MINIMIZER_H
+#define MINIMIZER_H
+
+#include "Expression.h"
+#include "Status.h"
+#include "Table.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Embeddable entry points: no exit(), no console output and no files are
+// written. Every call works on its own Expression/Table, so calls from
+// different threads never share state.
+
+struct MinimizeOptions {
+    bool allSolutions = true; // keep every minimal cover, not just the first one
+    PIEngine piEngine = PIEngine::Auto;
+    size_t memoryBudget = 0;  // bytes for the prime implicant merge before spilling to disk, 0 = no limit
+    string spillDirectory;
+    CoverEngine coverEngine = CoverEngine::Auto;
+    bool parallel = true;     // solve independent blocks of the cover table on the shared pool
+    // A run past timeLimitMs (0 = none) or with cancel stopped returns the
+    // best valid cover found so far and clears MinimizeResult::exact
+    int timeLimitMs = 0;
+    const CancelToken *cancel = nullptr;
+    // Split into Shannon cofactors that are minimized in parallel and merged
+    // (see ShannonSplit.h); splitDepth -1 sizes the cofactors automatically.
+    // The result is a single irredundant cover, not proven minimal.
+    bool shannonSplit = false;
+    int splitDepth = -1;
+    // Minimize the off-set as well, concurrently, and keep whichever phase
+    // needs fewer gate inputs (see MinimizeResult::complemented)
+    bool dualPhase = false;
+    // Detect groups of interchangeable inputs first and, when there are
+    // any, solve the function up to permutations of them (see Symmetry.h):
+    // fewer primes to grow and one cover per orbit, at most maxSolutions
+    // of them (0 = all, allSolutions false = 1)
+    bool symmetry = false;
+    size_t maxSolutions = 0;
+    // Approximate mode, on when either budget is set: on-set or off-set
+    // points are turned into don't-cares where that shrinks the cover, as
+    // long as the cover gets at most maxErrorPoints points wrong and their
+    // total probability stays within maxErrorProbability (0 = no limit of
+    // that kind). pointProbability gives each input's probability, indexed
+    // like minterms; empty means uniform. See Approximation.h.
+    size_t maxErrorPoints = 0;
+    double maxErrorProbability = 0;
+    vector<double> pointProbability;
+};
+
+struct MinimizeResult {
+    Status status = Status::Ok;
+    string error;
+    int numVariables = 0;
+    bool exact = true;                // solutions are proven minimal
+    vector<string> primeImplicants;   // cubes over {0,1,-}, variable A first
+    vector<vector<string>> solutions; // each one a complete cover (EPIs included)
+    vector<string> expressions;       // solutions written as "AB' + C"
+    // Set when the off-set won a dual-phase run: solutions are covers of F'
+    // and expressions give F as a product of sums, "(A' + B)(C)"
+    bool complemented = false;
+    // The function that was minimized, so a later edit can be applied to it
+    vector<int> onSet, dcSet;
+    bool allPrimes = false;           // primeImplicants holds every prime, not a subset
+    // Symmetry mode: the groups found (0 is A) and how many primes had to
+    // be grown, one per orbit, before they were expanded
+    vector<vector<int>> symmetricGroups;
+    size_t representativePrimes = 0;
+    // Approximate mode: the points the cover gets wrong, their probability,
+    // and the gate inputs of the exact cover and of the one returned
+    vector<int> errorPoints;
+    double errorProbability = 0;
+    size_t exactCost = 0, cost = 0;
+    // Number of primes; with PIEngine::Zdd they stay on the diagram and
+    // primeImplicants is left empty
+    double primeCount = 0;
+};
+
+// An edit to a function: points that join or leave the on-set and don't-cares
+struct SpecDelta {
+    vector<int> addOn, removeOn;
+    vector<int> addDc, removeDc;
+};
+
+Status minimize(int numVariables, const vector<int> &onSet, const vector<int> &dcSet,
+                MinimizeResult &result, const MinimizeOptions &options = MinimizeOptions());
+// spec uses the input file format: variable count, m/M terms, d terms
+Status minimize(const string &spec, MinimizeResult &result,
+                const MinimizeOptions &options = MinimizeOptions());
+Status minimize(const Expression &expression, MinimizeResult &result,
+                const MinimizeOptions &options = MinimizeOptions());
+// Minimizes previous's function with delta applied, reusing its primes and
+// first cover: only primes near the edited points are regenerated and only
+// the part of the cover they touch is solved again (see PrimeUpdate.h). The
+// cover is irredundant but not proven minimal. Falls back to a full minimize
+// when previous failed or its primes are incomplete (time limit, Shannon mode).
+Status reminimize(const MinimizeResult &previous, const SpecDelta &delta, MinimizeResult &result,
+                  const MinimizeOptions &options = MinimizeOptions());
+
+#endif // MINIMIZER_H
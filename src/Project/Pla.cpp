@@ -0,0 +1,214 @@
+#include "Pla.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '|';
+}
+
+static const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p)) p++;
+    return p;
+}
+
+static const char *wordEnd(const char *p, const char *end) {
+    while (p < end && !isBlank(*p)) p++;
+    return p;
+}
+
+static bool isWord(const char *p, const char *q, const char *word) {
+    size_t length = strlen(word);
+    return size_t(q - p) == length && memcmp(p, word, length) == 0;
+}
+
+static vector<string> readLabels(const char *p, const char *end) {
+    vector<string> labels;
+    for (p = skipBlanks(p, end); p < end; p = skipBlanks(p, end)) {
+        const char *q = wordEnd(p, end);
+        labels.emplace_back(p, q);
+        p = q;
+    }
+    return labels;
+}
+
+Status Pla::fail(Status status, const string &message) {
+    error = "line " + to_string(lineNumber) + ": " + message;
+    return status;
+}
+
+Status Pla::read(istream &in) {
+    numInputs = numOutputs = 0;
+    type = "fd";
+    inputLabels.clear();
+    outputLabels.clear();
+    onSets.clear();
+    dcSets.clear();
+    marks.clear();
+    error.clear();
+    lineNumber = 0;
+    string phase;
+
+    string line; // capacity is kept from line to line
+    while (getline(in, line)) {
+        lineNumber++;
+        const char *p = line.data(), *end = p + line.size();
+        if (const char *comment = static_cast<const char *>(memchr(p, '#', line.size()))) end = comment;
+        p = skipBlanks(p, end);
+        if (p == end) continue;
+
+        if (*p != '.') {
+            Status status = readRow(p, end);
+            if (status != Status::Ok) return status;
+            continue;
+        }
+
+        const char *q = wordEnd(p, end);
+        const char *rest = skipBlanks(q, end);
+        if (isWord(p, q, ".i")) {
+            numInputs = atoi(rest);
+            if (numInputs < 1 || numInputs > 20 || !marks.empty())
+                return fail(Status::InvalidVariableCount, "Invalid number of inputs.");
+        } else if (isWord(p, q, ".o")) {
+            numOutputs = atoi(rest);
+            if (numOutputs < 1 || !marks.empty()) return fail(Status::InvalidTermCount, "Invalid number of outputs.");
+        } else if (isWord(p, q, ".ilb")) {
+            inputLabels = readLabels(rest, end);
+        } else if (isWord(p, q, ".ob")) {
+            outputLabels = readLabels(rest, end);
+        } else if (isWord(p, q, ".type")) {
+            type.assign(rest, wordEnd(rest, end));
+            if (type != "f" && type != "fd" && type != "fr" && type != "fdr")
+                return fail(Status::UnknownTermType, "Unsupported .type " + type + ".");
+        } else if (isWord(p, q, ".phase")) {
+            phase.assign(rest, wordEnd(rest, end));
+        } else if (isWord(p, q, ".e") || isWord(p, q, ".end")) {
+            break;
+        } else if (isWord(p, q, ".mv") || isWord(p, q, ".kiss")) {
+            return fail(Status::FileError, "Multiple-valued PLAs are not supported.");
+        }
+        // .p, .pair, .symbolic and the like carry nothing the sets need
+    }
+
+    if (numInputs == 0) return fail(Status::InvalidVariableCount, "Missing .i line.");
+    if (numOutputs == 0) numOutputs = 1;
+    if (marks.empty()) marks.assign(numOutputs, vector<uint8_t>(size_t(1) << numInputs, 0));
+
+    onSets.assign(numOutputs, {});
+    dcSets.assign(numOutputs, {});
+    bool given[3] = { true, type == "fr" || type == "fdr", type == "fd" || type == "fdr" };
+    for (int j = 0; j < numOutputs; j++) {
+        // With phase 0 the rows describe F', so on and off trade places
+        bool inverted = j < int(phase.size()) && phase[j] == '0';
+        for (size_t x = 0; x < marks[j].size(); x++) {
+            uint8_t m = marks[j][x];
+            bool on = given[0] && (m & On), off = given[1] && (m & Off), dc = given[2] && (m & DontCare);
+            if (on && off && !dc) {
+                error = "Point " + to_string(x) + " of output " + to_string(j) +
+                        " is in both the on-set and the off-set.";
+                return Status::TermConflict;
+            }
+            // A point no row gives is off for f and fd, a don't-care for fr and fdr
+            if (!on && !off && !dc) (given[1] ? dc : off) = true;
+            if (inverted) swap(on, off);
+            if (dc) dcSets[j].push_back(int(x));
+            else if (on) onSets[j].push_back(int(x));
+        }
+    }
+    marks.clear();
+    return Status::Ok;
+}
+
+Status Pla::readRow(const char *p, const char *end) {
+    if (numInputs == 0) return fail(Status::InvalidVariableCount, "Cube row before the .i line.");
+
+    uint32_t bits = 0, dashes = 0;
+    for (int i = 0; i < numInputs; i++, p++) {
+        p = skipBlanks(p, end);
+        if (p == end) return fail(Status::InvalidTerm, "Row is shorter than .i inputs.");
+        bits <<= 1;
+        dashes <<= 1;
+        if (*p == '1') bits |= 1;
+        else if (*p == '-' || *p == '2') dashes |= 1;
+        else if (*p != '0') return fail(Status::InvalidTerm, string("Invalid input value '") + *p + "'.");
+    }
+
+    // Without a .o line the first row says how many outputs there are
+    if (numOutputs == 0)
+        for (const char *q = p; q < end; q++) numOutputs += !isBlank(*q);
+    if (numOutputs == 0) numOutputs = 1;
+    if (marks.empty()) marks.assign(numOutputs, vector<uint8_t>(size_t(1) << numInputs, 0));
+
+    targets.clear();
+    for (int j = 0; j < numOutputs; j++, p++) {
+        p = skipBlanks(p, end);
+        if (p == end) return fail(Status::InvalidTerm, "Row is shorter than .o outputs.");
+        uint8_t mark;
+        switch (*p) {
+            case '1': case '4': mark = On; break;
+            case '0': case '3': mark = Off; break;
+            case '-': case '2': mark = DontCare; break;
+            case '~': continue;
+            default: return fail(Status::InvalidTerm, string("Invalid output value '") + *p + "'.");
+        }
+        targets.push_back({ j, mark });
+    }
+    if (skipBlanks(p, end) != end) return fail(Status::InvalidTerm, "Row is longer than .i plus .o values.");
+
+    uint32_t sub = 0;
+    do {
+        uint32_t x = bits | sub;
+        for (const auto &[j, mark] : targets) marks[j][x] |= mark;
+        sub = (sub - dashes) & dashes;
+    } while (sub != 0);
+    return Status::Ok;
+}
+
+void Pla::write(ostream &out, const vector<MinimizeResult> &outputs, const vector<string> &inputLabels,
+                const vector<string> &outputLabels) {
+    int numInputs = 0;
+    bool anyComplemented = false;
+    for (const auto &result : outputs) {
+        numInputs = max(numInputs, result.numVariables);
+        anyComplemented = anyComplemented || result.complemented;
+    }
+
+    // One row per distinct input cube, in first-seen order
+    vector<const string *> cubes;
+    vector<string> columns;
+    unordered_map<string, size_t> rowOf;
+    for (size_t j = 0; j < outputs.size(); j++) {
+        if (outputs[j].solutions.empty()) continue;
+        for (const auto &cube : outputs[j].solutions[0]) {
+            auto [it, inserted] = rowOf.emplace(cube, cubes.size());
+            if (inserted) {
+                cubes.push_back(&it->first);
+                columns.emplace_back(outputs.size(), '0');
+            }
+            columns[it->second][j] = '1';
+        }
+    }
+
+    out << ".i " << numInputs << "\n.o " << outputs.size() << "\n";
+    if (!inputLabels.empty()) {
+        out << ".ilb";
+        for (const auto &label : inputLabels) out << ' ' << label;
+        out << '\n';
+    }
+    if (!outputLabels.empty()) {
+        out << ".ob";
+        for (const auto &label : outputLabels) out << ' ' << label;
+        out << '\n';
+    }
+    if (anyComplemented) {
+        out << ".phase ";
+        for (const auto &result : outputs) out << (result.complemented ? '0' : '1');
+        out << '\n';
+    }
+    out << ".type f\n.p " << cubes.size() << '\n';
+    for (size_t r = 0; r < cubes.size(); r++) out << *cubes[r] << ' ' << columns[r] << '\n';
+    out << ".e\n";
+}
@@ -0,0 +1,51 @@
+// Pla.h
+#ifndef PLA_H
+#define PLA_H
+
+#include "Minimizer.h"
+#include "Status.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Berkeley PLA files (the espresso format of the MCNC/IWLS two-level
+// benchmarks): .i/.o/.ilb/.ob/.type/.phase/.p/.e keywords and cube rows
+// such as "1-0 10". The reader goes through the file once, reusing a single
+// line buffer and marking the points of each cube straight into per-output
+// bitmaps, so no string is allocated per token or per row.
+class Pla {
+public:
+    int numInputs = 0;
+    int numOutputs = 0;
+    string type = "fd"; // f, fd, fr or fdr: which of the on/off/dc sets the rows give
+    vector<string> inputLabels, outputLabels;
+    // Per output, ascending; for fr the don't-cares are the points no row
+    // gives. Outputs with a 0 in the .phase line are read as describing F'.
+    vector<vector<int>> onSets, dcSets;
+    string error; // message for the last failed read
+
+    Status read(istream &in);
+
+    // Writes one cover per output as a .type f PLA, rows with the same input
+    // cube merged. Complemented dual-phase results are written as covers of
+    // F' with a 0 in the .phase line.
+    static void write(ostream &out, const vector<MinimizeResult> &outputs,
+                      const vector<string> &inputLabels = {}, const vector<string> &outputLabels = {});
+
+private:
+    enum : uint8_t { On = 1, Off = 2, DontCare = 4 };
+
+    Status fail(Status status, const string &message);
+    Status readRow(const char *p, const char *end);
+
+    vector<vector<uint8_t>> marks;       // per output, per point: On | Off | DontCare
+    vector<pair<int, uint8_t>> targets;  // (output, mark) of the current row
+    int lineNumber = 0;
+};
+
+#endif // PLA_H
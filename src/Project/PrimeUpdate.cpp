@@ -0,0 +1,138 @@
+#include "PrimeUpdate.h"
+#include "CoverSearch.h"
+#include "GreedyCover.h"
+#include "Term.h"
+#include <algorithm>
+
+using namespace std;
+
+static bool cubeContains(uint32_t bits, uint32_t dashes, uint32_t x) {
+    return ((x ^ bits) & ~dashes) == 0;
+}
+
+PrimeUpdate::PrimeUpdate(int numVariables, const vector<int> &oldOn, const vector<int> &oldDc,
+                         const vector<int> &newOn, const vector<int> &newDc)
+    : numVariables(numVariables), newOn(newOn) {
+    size_t words = ((size_t(1) << numVariables) + 63) / 64;
+    vector<uint64_t> oldCare(words, 0);
+    care.assign(words, 0);
+    for (const auto *points : { &oldOn, &oldDc })
+        for (int x : *points) oldCare[x >> 6] |= uint64_t(1) << (x & 63);
+    for (const auto *points : { &newOn, &newDc })
+        for (int x : *points) care[x >> 6] |= uint64_t(1) << (x & 63);
+
+    for (size_t w = 0; w < words; w++) {
+        for (uint64_t gained = care[w] & ~oldCare[w]; gained; gained &= gained - 1)
+            added.push_back(int(w * 64 + __builtin_ctzll(gained)));
+        for (uint64_t lost = oldCare[w] & ~care[w]; lost; lost &= lost - 1)
+            removed.push_back(int(w * 64 + __builtin_ctzll(lost)));
+    }
+}
+
+void PrimeUpdate::addPrime(Cube cube) {
+    if (primeIndex.emplace(PrimeGrower::cubeKey(cube.first, cube.second), primes.size()).second)
+        primes.push_back(cube);
+}
+
+vector<string> PrimeUpdate::updatePrimes(const vector<string> &oldPrimes) {
+    PrimeGrower grower(numVariables, care);
+    vector<int> seeds = added;
+    for (const auto &prime : oldPrimes) {
+        uint32_t bits, dashes;
+        Term::pack(prime, bits, dashes);
+
+        bool lostPoint = any_of(removed.begin(), removed.end(),
+                                [&](int r) { return cubeContains(bits, dashes, r); });
+        if (lostPoint) {
+            // Its primes now are sub-cubes of it: grow them from what is left
+            uint32_t sub = 0;
+            do {
+                if (grower.inCare(bits | sub)) seeds.push_back(bits | sub);
+                sub = (sub - dashes) & dashes;
+            } while (sub != 0);
+            continue;
+        }
+
+        // A literal can only have become raisable if the opposite half
+        // gained a point; the larger cube is then grown from that point
+        bool raisable = false;
+        for (int v = 0; v < numVariables && !raisable; v++) {
+            uint32_t bit = 1u << v;
+            if (dashes & bit) continue;
+            bool gained = any_of(added.begin(), added.end(),
+                                 [&](int a) { return cubeContains(bits ^ bit, dashes, a); });
+            raisable = gained && grower.isImplicant(bits ^ bit, dashes);
+        }
+        if (!raisable) addPrime({ bits, dashes });
+    }
+    survivors = primes.size();
+
+    sort(seeds.begin(), seeds.end());
+    seeds.erase(unique(seeds.begin(), seeds.end()), seeds.end());
+    vector<Cube> grown;
+    for (int seed : seeds) grower.growPrimes(seed, grown);
+    for (const auto &cube : grown) addPrime(cube);
+
+    vector<string> result;
+    for (const auto &[bits, dashes] : primes)
+        result.push_back(Term::unpack(bits, dashes, numVariables));
+    return result;
+}
+
+vector<string> PrimeUpdate::updateCover(const vector<string> &oldCover, ThreadPool *pool,
+                                        const CancelToken *cancel) {
+    vector<Cube> cover;
+    for (const auto &cube : oldCover) {
+        uint32_t bits, dashes;
+        Term::pack(cube, bits, dashes);
+        auto it = primeIndex.find(PrimeGrower::cubeKey(bits, dashes));
+        if (it != primeIndex.end() && it->second < survivors) cover.push_back(primes[it->second]);
+    }
+
+    // Per on-set point, how many cover cubes contain it
+    vector<int> coverCount(size_t(1) << numVariables, 0);
+    auto forEachPoint = [](const Cube &cube, auto &&visit) {
+        uint32_t sub = 0;
+        do {
+            visit(cube.first | sub);
+            sub = (sub - cube.second) & cube.second;
+        } while (sub != 0);
+    };
+    for (const auto &cube : cover)
+        forEachPoint(cube, [&](uint32_t x) { coverCount[x]++; });
+
+    // Only the on-set points the surviving cubes leave open are re-solved
+    vector<int> open;
+    for (int x : newOn)
+        if (coverCount[x] == 0) open.push_back(x);
+    if (!open.empty()) {
+        vector<vector<int>> rows(open.size());
+        for (size_t r = 0; r < open.size(); r++)
+            for (size_t c = 0; c < primes.size(); c++)
+                if (cubeContains(primes[c].first, primes[c].second, open[r])) rows[r].push_back(c);
+
+        vector<int> chosen = GreedyCover::solve(rows);
+        if (!GreedyCover::preferred(rows)) {
+            CoverSearch solver(rows);
+            solver.allCovers = false;
+            vector<vector<int>> best = solver.solve(pool, chosen, cancel);
+            if (!best.empty()) chosen = best[0];
+        }
+        for (int c : chosen) {
+            cover.push_back(primes[c]);
+            forEachPoint(primes[c], [&](uint32_t x) { coverCount[x]++; });
+        }
+    }
+
+    // Old cubes the new primes made redundant go, oldest first
+    vector<uint8_t> onSet(coverCount.size(), 0);
+    for (int x : newOn) onSet[x] = 1;
+    vector<string> result;
+    for (const auto &cube : cover) {
+        bool needed = false;
+        forEachPoint(cube, [&](uint32_t x) { needed = needed || (onSet[x] && coverCount[x] == 1); });
+        if (needed) result.push_back(Term::unpack(cube.first, cube.second, numVariables));
+        else forEachPoint(cube, [&](uint32_t x) { coverCount[x]--; });
+    }
+    return result;
+}
@@ -0,0 +1,50 @@
+// PrimeUpdate.h
+#ifndef PRIMEUPDATE_H
+#define PRIMEUPDATE_H
+
+#include "CancelToken.h"
+#include "Term.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Carries the primes and a cover of a function over to an edited version of
+// it without a rebuild. An old prime stays prime unless it now contains a
+// removed point, or one of its literals can be raised because the opposite
+// half gained points. Every new prime either contains an added point or lies
+// inside a dropped old prime, so new primes are only grown from those points.
+// The cover keeps the old cubes that are still prime and only covers the
+// on-set points they leave open.
+class PrimeUpdate {
+public:
+    // Sets are the on-set and don't-care set before and after the edit
+    PrimeUpdate(int numVariables, const vector<int> &oldOn, const vector<int> &oldDc,
+                const vector<int> &newOn, const vector<int> &newDc);
+
+    // Primes of the edited function: the surviving old ones in their old
+    // order, then the new ones
+    vector<string> updatePrimes(const vector<string> &oldPrimes);
+    // A cover of the edited function from the primes of updatePrimes
+    vector<string> updateCover(const vector<string> &oldCover, ThreadPool *pool,
+                               const CancelToken *cancel);
+
+private:
+    typedef PrimeGrower::Cube Cube;
+
+    void addPrime(Cube cube);
+
+    int numVariables;
+    vector<int> newOn;
+    vector<uint64_t> care;           // new on-set plus don't-cares
+    vector<int> added, removed;      // points that joined or left the care set
+    vector<Cube> primes;
+    unordered_map<uint64_t, size_t> primeIndex;
+    size_t survivors = 0;            // primes[0, survivors) were old primes
+};
+
+#endif // PRIMEUPDATE_H
@@ -0,0 +1,300 @@
+#include "Server.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+static bool readFully(int fd, void *buffer, size_t size) {
+    char *p = static_cast<char *>(buffer);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool writeFully(int fd, const void *buffer, size_t size) {
+    const char *p = static_cast<const char *>(buffer);
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Input still queued when the socket closes resets the connection, which can
+// cost the client replies it has not read yet (after a rejected frame, say),
+// so the read side is shut and drained first
+Server::Connection::~Connection() {
+    shutdown(fd, SHUT_RD);
+    char discard[4096];
+    while (recv(fd, discard, sizeof(discard), MSG_DONTWAIT) > 0) {
+    }
+    close(fd);
+}
+
+Server::Server(const string &socketPath, size_t threads, size_t batchSize, size_t cacheCapacity)
+    : socketPath(socketPath), batchSize(max<size_t>(batchSize, 1)),
+      cacheCapacity(cacheCapacity), pool(threads) {}
+
+Server::~Server() {
+    stop();
+}
+
+int Server::warm(int maxVariables) {
+    if (maxVariables < 0) maxVariables = 0;
+    if (maxVariables > MaxWarmVariables) maxVariables = MaxWarmVariables;
+    // Each function of n variables assigns one of off/on/dc to all 2^n points
+    for (int n = 1; n <= maxVariables; n++) {
+        int points = 1 << n;
+        int functions = 1;
+        for (int i = 0; i < points; i++) functions *= 3;
+        for (int f = 0; f < functions; f++) {
+            pool.submit([this, n, points, f] {
+                vector<int> onSet, dcSet;
+                int code = f;
+                for (int p = 0; p < points; p++, code /= 3) {
+                    if (code % 3 == 1) onSet.push_back(p);
+                    if (code % 3 == 2) dcSet.push_back(p);
+                }
+                Expression expression;
+                if (expression.readInput(n, onSet, dcSet) != Status::Ok) return;
+                MinimizeResult result;
+                minimize(expression, result);
+                store(cacheKey(expression), result);
+            });
+        }
+    }
+    pool.wait();
+    return maxVariables;
+}
+
+string Server::cacheKey(const Expression &expression) {
+    vector<int> on, dc;
+    for (const auto &t : expression.minterms) on.push_back(t.value);
+    for (const auto &t : expression.dontCares) dc.push_back(t.value);
+    sort(on.begin(), on.end());
+    sort(dc.begin(), dc.end());
+    string key = to_string(expression.numVariables) + ":";
+    for (int v : on) key += to_string(v) + ",";
+    key += "|";
+    for (int v : dc) key += to_string(v) + ",";
+    return key;
+}
+
+bool Server::lookup(const string &key, MinimizeResult &result) {
+    lock_guard<mutex> guard(cacheLock);
+    auto it = cache.find(key);
+    if (it == cache.end()) return false;
+    result = it->second;
+    return true;
+}
+
+void Server::store(const string &key, const MinimizeResult &result) {
+    if (cacheCapacity == 0) return;
+    lock_guard<mutex> guard(cacheLock);
+    if (!cache.emplace(key, result).second) return;
+    cacheOrder.push_back(key);
+    if (cacheOrder.size() > cacheCapacity) {
+        cache.erase(cacheOrder.front());
+        cacheOrder.pop_front();
+    }
+}
+
+string Server::formatReply(const MinimizeResult &result) {
+    string reply = statusName(result.status);
+    reply += "\n";
+    if (result.status != Status::Ok) reply += "error: " + result.error + "\n";
+    for (const auto &solution : result.solutions) {
+        for (size_t i = 0; i < solution.size(); i++) {
+            if (i > 0) reply += " ";
+            reply += solution[i];
+        }
+        reply += "\n";
+    }
+    return reply;
+}
+
+string Server::answer(const Request &request) {
+    Expression expression;
+    Status status;
+    if (request.type == 'T') {
+        istringstream in(request.payload);
+        status = expression.readInput(in);
+    } else {
+        const string &p = request.payload;
+        uint32_t header[3];
+        if (p.size() < sizeof(header)) return "invalid term\nerror: Truncated binary spec.\n";
+        memcpy(header, p.data(), sizeof(header));
+        size_t count = size_t(header[1]) + header[2];
+        if (p.size() != sizeof(header) + count * sizeof(uint32_t))
+            return "invalid term\nerror: Binary spec length does not match its term counts.\n";
+        vector<uint32_t> values(count);
+        memcpy(values.data(), p.data() + sizeof(header), count * sizeof(uint32_t));
+        vector<int> onSet(values.begin(), values.begin() + header[1]);
+        vector<int> dcSet(values.begin() + header[1], values.end());
+        status = expression.readInput(int(header[0]), onSet, dcSet);
+    }
+
+    MinimizeResult result;
+    if (status != Status::Ok) {
+        result.status = status;
+        result.error = expression.error;
+        return formatReply(result);
+    }
+    string key = cacheKey(expression);
+    if (!lookup(key, result)) {
+        minimize(expression, result);
+        store(key, result);
+    }
+    return formatReply(result);
+}
+
+// Sends the reply with the given sequence number along with every later one
+// that was waiting on it; a reply that finishes early is parked until then
+bool Server::writeReply(Connection &connection, uint64_t sequence, uint32_t id, string reply) {
+    lock_guard<mutex> guard(connection.writeLock);
+    connection.early.emplace(sequence, make_pair(id, move(reply)));
+    bool sent = true;
+    auto it = connection.early.begin();
+    while (it != connection.early.end() && it->first == connection.nextReply) {
+        const string &payload = it->second.second;
+        char header[9];
+        uint32_t length = payload.size();
+        header[0] = 'R';
+        memcpy(header + 1, &it->second.first, 4);
+        memcpy(header + 5, &length, 4);
+        sent = sent && writeFully(connection.fd, header, sizeof(header)) &&
+               writeFully(connection.fd, payload.data(), length);
+        it = connection.early.erase(it);
+        connection.nextReply++;
+    }
+    return sent;
+}
+
+void Server::processBatch(shared_ptr<Connection> connection, const vector<Request> &batch) {
+    for (const auto &request : batch)
+        if (!writeReply(*connection, request.sequence, request.id, answer(request))) return; // client went away
+}
+
+// Splits a batch into one slice per worker so a pipelined burst is solved in
+// parallel instead of by a single task
+void Server::dispatch(shared_ptr<Connection> connection, vector<Request> &batch) {
+    size_t slice = (batch.size() + max<size_t>(pool.size(), 1) - 1) / max<size_t>(pool.size(), 1);
+    for (size_t begin = 0; begin < batch.size(); begin += slice) {
+        auto first = batch.begin() + begin, last = batch.begin() + min(begin + slice, batch.size());
+        vector<Request> work(make_move_iterator(first), make_move_iterator(last));
+        pool.submit([this, connection, work = move(work)] { processBatch(connection, work); });
+    }
+    batch.clear();
+}
+
+void Server::serveConnection(shared_ptr<Connection> connection) {
+    vector<Request> batch;
+    uint64_t sequence = 0;
+    while (!stopping) {
+        char header[9];
+        if (!readFully(connection->fd, header, sizeof(header))) break;
+        Request request;
+        request.sequence = sequence++;
+        uint32_t length;
+        request.type = header[0];
+        memcpy(&request.id, header + 1, 4);
+        memcpy(&length, header + 5, 4);
+        if (length > MaxPayload) {
+            string reply = "invalid number of terms\nerror: Frame payload is longer than " +
+                           to_string(MaxPayload) + " bytes.\n";
+            writeReply(*connection, request.sequence, request.id, reply);
+            break;
+        }
+        request.payload.resize(length);
+        if (!readFully(connection->fd, &request.payload[0], length)) break;
+        if (request.type != 'T' && request.type != 'B') {
+            string reply = string(statusName(Status::UnknownTermType)) + "\nerror: Unknown frame type " +
+                           to_string(int(uint8_t(request.type))) + ", expected 'T' or 'B'.\n";
+            writeReply(*connection, request.sequence, request.id, reply);
+            break;
+        }
+        batch.push_back(move(request));
+
+        // Keep collecting while more requests are already waiting on the socket
+        pollfd pending = { connection->fd, POLLIN, 0 };
+        if (batch.size() < batchSize && poll(&pending, 1, 0) > 0 && (pending.revents & POLLIN))
+            continue;
+        dispatch(connection, batch);
+    }
+    if (!batch.empty()) dispatch(connection, batch);
+}
+
+int Server::run() {
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        cerr << "Error: Unable to create socket." << endl;
+        return 1;
+    }
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: Socket path too long." << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(listenFd, 64) < 0) {
+        cerr << "Error: Unable to listen on " << socketPath << endl;
+        return 1;
+    }
+
+    while (!stopping) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (stopping) break;
+            continue;
+        }
+        auto connection = make_shared<Connection>(fd);
+        lock_guard<mutex> guard(clientsLock);
+        if (stopping) break; // stop() has already swept the clients
+        // Join the readers of clients that hung up so the list stays small
+        for (auto it = clients.begin(); it != clients.end();) {
+            if (!it->connection.expired()) {
+                ++it;
+                continue;
+            }
+            it->reader.join();
+            it = clients.erase(it);
+        }
+        clients.push_back({ connection, thread(&Server::serveConnection, this, connection) });
+    }
+    return 0;
+}
+
+void Server::stop() {
+    if (stopping.exchange(true)) return;
+    if (listenFd >= 0) {
+        shutdown(listenFd, SHUT_RDWR);
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    // Wake every reader blocked on its client, then wait for it to finish
+    list<Client> open;
+    {
+        lock_guard<mutex> guard(clientsLock);
+        open.swap(clients);
+    }
+    for (auto &client : open) {
+        if (auto connection = client.connection.lock()) shutdown(connection->fd, SHUT_RDWR);
+        client.reader.join();
+    }
+}
@@ -0,0 +1,94 @@
+// Server.h
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "Minimizer.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Long-running minimizer listening on a Unix domain socket.
+//
+// Every message is a frame: 1 byte type, 4 byte request id, 4 byte payload
+// length (host byte order), then the payload.
+//   'T'  payload is a spec in the input file format (count, m/M line, d line)
+//   'B'  payload is uint32 numVariables, onCount, dcCount, then the values
+// Each request is answered with an 'R' frame carrying the same id. Requests
+// that arrive together are spread over the workers, but replies are always
+// sent in the order their requests arrived on the connection.
+// The reply payload is the status name on the first line, "error: ..." on
+// failure, then one line per minimal cover listing its cubes.
+//
+// A frame whose payload is longer than MaxPayload, or whose type is neither
+// 'T' nor 'B', is answered with an error reply and the connection is closed
+// once the replies to the requests before it have been sent.
+class Server {
+public:
+    static const uint32_t MaxPayload = 16 << 20; // bytes, about 4M binary terms
+    static const int MaxWarmVariables = 3;        // 4 variables would be 3^16 functions
+
+    Server(const string &socketPath, size_t threads, size_t batchSize = 32,
+           size_t cacheCapacity = 100000);
+    ~Server();
+    // Precomputes every function of 1..maxVariables variables. maxVariables is
+    // clamped to MaxWarmVariables; returns the count actually warmed.
+    int warm(int maxVariables);
+    int run();                   // accept loop, returns non-zero if the socket fails
+    void stop();
+
+private:
+    struct Request {
+        uint64_t sequence; // position on its connection
+        uint32_t id;
+        char type;
+        string payload;
+    };
+    struct Connection {
+        int fd;
+        mutex writeLock;
+        uint64_t nextReply = 0;                      // sequence of the next reply to send
+        map<uint64_t, pair<uint32_t, string>> early; // id and reply of those done before it
+        explicit Connection(int fd) : fd(fd) {}
+        ~Connection();
+    };
+    struct Client {
+        weak_ptr<Connection> connection; // expires once the reader and its replies are done
+        thread reader;                   // runs serveConnection
+    };
+
+    void serveConnection(shared_ptr<Connection> connection);
+    void dispatch(shared_ptr<Connection> connection, vector<Request> &batch);
+    void processBatch(shared_ptr<Connection> connection, const vector<Request> &batch);
+    string answer(const Request &request);
+    bool lookup(const string &key, MinimizeResult &result);
+    void store(const string &key, const MinimizeResult &result);
+    static string cacheKey(const Expression &expression);
+    static string formatReply(const MinimizeResult &result);
+    static bool writeReply(Connection &connection, uint64_t sequence, uint32_t id, string reply);
+
+    string socketPath;
+    size_t batchSize;
+    size_t cacheCapacity;
+    int listenFd = -1;
+    atomic<bool> stopping{false};
+
+    mutex clientsLock;
+    list<Client> clients; // joined by stop()
+
+    mutex cacheLock;
+    map<string, MinimizeResult> cache;
+    deque<string> cacheOrder; // insertion order, oldest evicted first
+
+    ThreadPool pool; // last, so workers are joined before the cache goes away
+};
+
+#endif // SERVER_H
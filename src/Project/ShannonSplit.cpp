@@ -0,0 +1,135 @@
+#include "ShannonSplit.h"
+#include "GreedyCover.h"
+#include "Term.h"
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+ShannonSplit::ShannonSplit(int numVariables, const vector<int> &onSet, const vector<int> &dcSet)
+    : numVariables(numVariables), onSet(onSet), dcSet(dcSet) {
+    care.assign(((size_t(1) << numVariables) + 63) / 64, 0);
+    for (int x : onSet) care[x >> 6] |= uint64_t(1) << (x & 63);
+    for (int x : dcSet) care[x >> 6] |= uint64_t(1) << (x & 63);
+}
+
+vector<ShannonSplit::Cofactor> ShannonSplit::split(int depth, size_t leafPoints) const {
+    if (leafPoints == 0) {
+        // About four cofactors per core, but none so small that the merge
+        // pass has more to recover than the split saved
+        size_t cores = max(1u, thread::hardware_concurrency());
+        leafPoints = max<size_t>(2048, (onSet.size() + dcSet.size()) / (4 * cores));
+    }
+    Cofactor whole;
+    whole.onSet = onSet;
+    whole.dcSet = dcSet;
+    vector<Cofactor> leaves;
+    divide(whole, depth, leafPoints, leaves);
+    return leaves;
+}
+
+void ShannonSplit::divide(const Cofactor &cofactor, int depth, size_t leafPoints,
+                          vector<Cofactor> &leaves) const {
+    bool small = cofactor.onSet.size() + cofactor.dcSet.size() <= leafPoints;
+    int v = depth == 0 || (depth < 0 && small) ? -1 : chooseVariable(cofactor);
+    if (v < 0) {
+        leaves.push_back(cofactor);
+        return;
+    }
+
+    uint32_t bit = 1u << v;
+    Cofactor half[2];
+    for (int side = 0; side < 2; side++) {
+        half[side].fixedMask = cofactor.fixedMask | bit;
+        half[side].fixedValue = cofactor.fixedValue | (side ? bit : 0);
+    }
+    for (int x : cofactor.onSet) half[(x & bit) != 0].onSet.push_back(x);
+    for (int x : cofactor.dcSet) half[(x & bit) != 0].dcSet.push_back(x);
+    for (int side = 0; side < 2; side++)
+        divide(half[side], depth < 0 ? depth : depth - 1, leafPoints, leaves);
+}
+
+// Split on the free variable that the fewest adjacent pairs of care points
+// straddle (fewest primes cut in two), then on the most even on-set split.
+// Variables that leave one side without on-set points are not useful.
+int ShannonSplit::chooseVariable(const Cofactor &cofactor) const {
+    int best = -1;
+    size_t bestCrossing = 0, bestImbalance = 0;
+    for (int v = numVariables - 1; v >= 0; v--) {
+        uint32_t bit = 1u << v;
+        if (cofactor.fixedMask & bit) continue;
+        size_t ones = 0;
+        for (int x : cofactor.onSet) ones += (x & bit) != 0;
+        if (ones == 0 || ones == cofactor.onSet.size()) continue;
+
+        size_t crossing = 0;
+        for (const auto *points : { &cofactor.onSet, &cofactor.dcSet })
+            for (int x : *points) {
+                if (x & bit) continue;
+                int y = x | bit;
+                crossing += (care[y >> 6] >> (y & 63)) & 1;
+            }
+        size_t zeros = cofactor.onSet.size() - ones;
+        size_t imbalance = ones > zeros ? ones - zeros : zeros - ones;
+        if (best < 0 || crossing < bestCrossing ||
+            (crossing == bestCrossing && imbalance < bestImbalance)) {
+            best = v;
+            bestCrossing = crossing;
+            bestImbalance = imbalance;
+        }
+    }
+    return best;
+}
+
+bool ShannonSplit::insideCare(uint32_t bits, uint32_t dashes) const {
+    for (uint32_t s = dashes;; s = (s - 1) & dashes) {
+        uint32_t x = bits | s;
+        if (!((care[x >> 6] >> (x & 63)) & 1)) return false;
+        if (s == 0) return true;
+    }
+}
+
+vector<string> ShannonSplit::merge(const vector<string> &cubes, vector<string> &primes) const {
+    // Expand: raise a literal whenever the opposite half of the cube is
+    // also inside the function, until no literal can go
+    vector<pair<uint32_t, uint32_t>> expanded; // (dashes, bits)
+    for (const auto &cube : cubes) {
+        uint32_t bits, dashes;
+        Term::pack(cube, bits, dashes);
+        for (int v = numVariables - 1; v >= 0; v--) {
+            uint32_t bit = 1u << v;
+            if (dashes & bit) continue;
+            if (!insideCare(bits ^ bit, dashes)) continue;
+            dashes |= bit;
+            bits &= ~bit;
+        }
+        expanded.push_back({ dashes, bits });
+    }
+    // A cube none of whose literals can be raised is prime, so the distinct
+    // expanded cubes never contain one another
+    sort(expanded.begin(), expanded.end());
+    expanded.erase(unique(expanded.begin(), expanded.end()), expanded.end());
+
+    // Irredundant cover of the on-set from the merged primes
+    vector<int> rowOf(size_t(1) << numVariables, -1);
+    for (size_t r = 0; r < onSet.size(); r++) rowOf[onSet[r]] = r;
+    vector<vector<int>> rows(onSet.size());
+    for (size_t c = 0; c < expanded.size(); c++) {
+        auto [dashes, bits] = expanded[c];
+        for (uint32_t s = dashes;; s = (s - 1) & dashes) {
+            int r = rowOf[bits | s];
+            if (r >= 0) rows[r].push_back(c);
+            if (s == 0) break;
+        }
+    }
+
+    primes.clear();
+    for (const auto &[dashes, bits] : expanded)
+        primes.push_back(Term::unpack(bits, dashes, numVariables));
+    vector<string> cover;
+    for (int c : GreedyCover::solve(rows))
+        cover.push_back(primes[c]);
+    sort(cover.begin(), cover.end());
+    return cover;
+}
@@ -0,0 +1,50 @@
+// ShannonSplit.h
+#ifndef SHANNONSPLIT_H
+#define SHANNONSPLIT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Divide and conquer for functions too large for one Table. The function is
+// split recursively on single variables (f = x'.f0 + x.f1); each cofactor
+// keeps all n variables with the split ones fixed, so its cover can be used
+// as is. The cofactor covers are then joined and every cube is expanded
+// against the whole function, which recovers the primes that cross a split.
+class ShannonSplit {
+public:
+    struct Cofactor {
+        uint32_t fixedMask = 0;  // variables set by the splits (bit n-1 is A)
+        uint32_t fixedValue = 0;
+        vector<int> onSet;
+        vector<int> dcSet;
+    };
+
+    ShannonSplit(int numVariables, const vector<int> &onSet, const vector<int> &dcSet);
+
+    // Splits while a cofactor has more than leafPoints on/dc points, or to
+    // exactly depth levels when depth >= 0. leafPoints = 0 derives it from
+    // the size of the function and the number of cores.
+    vector<Cofactor> split(int depth = -1, size_t leafPoints = 0) const;
+
+    // Joins cofactor covers (cubes over {0,1,-}, variable A first): every
+    // cube is expanded to a prime of the whole function, the distinct
+    // primes go into primes, and an irredundant subset of them covering the
+    // on-set is returned.
+    vector<string> merge(const vector<string> &cubes, vector<string> &primes) const;
+
+private:
+    int chooseVariable(const Cofactor &cofactor) const;
+    void divide(const Cofactor &cofactor, int depth, size_t leafPoints,
+                vector<Cofactor> &leaves) const;
+    bool insideCare(uint32_t bits, uint32_t dashes) const;
+
+    int numVariables;
+    vector<int> onSet;
+    vector<int> dcSet;
+    vector<uint64_t> care; // on-set plus don't-cares, one bit per point
+};
+
+#endif // SHANNONSPLIT_H
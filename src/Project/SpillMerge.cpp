@@ -0,0 +1,198 @@
+#include "SpillMerge.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <queue>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Keys sort by dash pattern, then number of ones, then bits
+static uint64_t makeKey(uint32_t bits, uint32_t dashes) {
+    return uint64_t(dashes) << 37 | uint64_t(__builtin_popcount(bits)) << 32 | bits;
+}
+static uint32_t keyBits(uint64_t key) { return uint32_t(key); }
+static uint32_t keyDashes(uint64_t key) { return uint32_t(key >> 37); }
+static uint64_t keyGroup(uint64_t key) { return key >> 32; }
+
+SpillMerge::SpillMerge(int numVariables, size_t memoryBudget, const string &directory)
+    : numVariables(numVariables), directory(directory) {
+    // Half the budget for the merged-cube buffer, the rest for the mapped
+    // pages and the merged flags
+    bufferKeys = max<size_t>(memoryBudget / 2 / sizeof(uint64_t), 1 << 16);
+    if (this->directory.empty()) {
+        const char *tmp = getenv("TMPDIR");
+        this->directory = tmp && *tmp ? tmp : "/tmp";
+    }
+}
+
+#ifdef _WIN32
+
+bool SpillMerge::supported() { return false; }
+
+bool SpillMerge::run(const vector<uint32_t> &, const vector<uint32_t> &, vector<Term> &,
+                     const function<bool()> &) {
+    return false;
+}
+
+#else
+
+bool SpillMerge::supported() { return true; }
+
+// Append-only file of keys, unlinked on creation and mapped read-only once
+// it is complete
+class KeyFile {
+public:
+    explicit KeyFile(const string &directory) {
+        string path = directory + "/quinify-spill-XXXXXX";
+        fd = mkstemp(&path[0]);
+        if (fd >= 0) unlink(path.c_str());
+    }
+    ~KeyFile() {
+        if (data) munmap(data, count * sizeof(uint64_t));
+        if (fd >= 0) close(fd);
+    }
+    bool ok() const { return fd >= 0 && !failed; }
+    size_t size() const { return count + pending.size(); }
+
+    void append(uint64_t key) {
+        pending.push_back(key);
+        if (pending.size() == 1 << 14) flush();
+    }
+    void append(const vector<uint64_t> &keys) {
+        for (uint64_t key : keys) append(key);
+    }
+    const uint64_t *map() {
+        flush();
+        if (count == 0 || failed) return nullptr;
+        void *p = mmap(nullptr, count * sizeof(uint64_t), PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            failed = true;
+            return nullptr;
+        }
+        data = p;
+        madvise(data, count * sizeof(uint64_t), MADV_SEQUENTIAL);
+        return static_cast<const uint64_t *>(data);
+    }
+
+private:
+    void flush() {
+        const char *p = reinterpret_cast<const char *>(pending.data());
+        size_t left = pending.size() * sizeof(uint64_t);
+        while (left > 0 && !failed) {
+            ssize_t written = write(fd, p, left);
+            if (written <= 0) failed = true;
+            else { p += written; left -= written; }
+        }
+        count += pending.size();
+        pending.clear();
+    }
+
+    int fd = -1;
+    bool failed = false;
+    size_t count = 0;
+    vector<uint64_t> pending;
+    void *data = nullptr;
+};
+
+bool SpillMerge::run(const vector<uint32_t> &bits, const vector<uint32_t> &dashes, vector<Term> &primes,
+                     const function<bool()> &interrupted) {
+    uint32_t allVariables = (1u << numVariables) - 1;
+    auto level = make_unique<KeyFile>(directory);
+    {
+        vector<uint64_t> keys(bits.size());
+        for (size_t i = 0; i < bits.size(); i++) keys[i] = makeKey(bits[i], dashes[i]);
+        sort(keys.begin(), keys.end());
+        level->append(keys);
+    }
+
+    vector<Term> found;
+    while (level->size() > 0) {
+        if (!level->ok()) return false;
+        size_t count = level->size();
+        const uint64_t *keys = level->map();
+        if (!keys) return false;
+        vector<uint64_t> merged((count + 63) / 64, 0);
+        vector<uint64_t> buffer;
+        vector<unique_ptr<KeyFile>> runs;
+        auto writeRun = [&] {
+            sort(buffer.begin(), buffer.end());
+            buffer.erase(unique(buffer.begin(), buffer.end()), buffer.end());
+            runs.push_back(make_unique<KeyFile>(directory));
+            runs.back()->append(buffer);
+            buffer.clear();
+        };
+
+        bool stopped = false;
+        for (size_t start = 0; start < count && !stopped;) {
+            stopped = interrupted();
+            size_t end = start;
+            while (end < count && keyGroup(keys[end]) == keyGroup(keys[start])) end++;
+            // Partners have the same dashes and one more 1: the next group
+            size_t nextEnd = end;
+            while (nextEnd < count && keyGroup(keys[nextEnd]) == keyGroup(keys[start]) + 1) nextEnd++;
+            for (size_t i = start; i < end && nextEnd > end; i++) {
+                uint32_t cubeBits = keyBits(keys[i]), cubeDashes = keyDashes(keys[i]);
+                for (uint32_t free = allVariables & ~(cubeBits | cubeDashes); free; free &= free - 1) {
+                    uint32_t bit = free & -free;
+                    uint64_t partner = makeKey(cubeBits | bit, cubeDashes);
+                    const uint64_t *at = lower_bound(keys + end, keys + nextEnd, partner);
+                    if (at == keys + nextEnd || *at != partner) continue;
+                    size_t j = at - keys;
+                    merged[i >> 6] |= uint64_t(1) << (i & 63);
+                    merged[j >> 6] |= uint64_t(1) << (j & 63);
+                    buffer.push_back(makeKey(cubeBits, cubeDashes | bit));
+                    if (buffer.size() >= bufferKeys) writeRun();
+                }
+            }
+            start = end;
+        }
+        if (!buffer.empty()) writeRun();
+
+        // Unmerged cubes are prime; a stopped merge keeps the whole level,
+        // which together with the primes so far still covers the function
+        vector<Term> levelPrimes;
+        for (size_t i = 0; i < count; i++)
+            if (stopped || !((merged[i >> 6] >> (i & 63)) & 1))
+                levelPrimes.push_back(Term::fromCube(keyBits(keys[i]), keyDashes(keys[i]), numVariables));
+        stable_sort(levelPrimes.begin(), levelPrimes.end(), [](const Term &a, const Term &b) {
+            int onesA = Term::countOnes(a.binary), onesB = Term::countOnes(b.binary);
+            return onesA != onesB ? onesA < onesB : a.binary < b.binary;
+        });
+        found.insert(found.end(), levelPrimes.begin(), levelPrimes.end());
+        if (stopped) break;
+
+        // Merge the sorted runs into the next level, dropping duplicates
+        auto next = make_unique<KeyFile>(directory);
+        typedef pair<uint64_t, size_t> Head; // (key, run)
+        priority_queue<Head, vector<Head>, greater<Head>> heads;
+        vector<const uint64_t *> cursor(runs.size()), limit(runs.size());
+        for (size_t r = 0; r < runs.size(); r++) {
+            if (!runs[r]->ok()) return false;
+            size_t runSize = runs[r]->size();
+            cursor[r] = runs[r]->map();
+            if (!cursor[r]) return false;
+            limit[r] = cursor[r] + runSize;
+            heads.push({ *cursor[r]++, r });
+        }
+        bool any = false;
+        uint64_t last = 0;
+        while (!heads.empty()) {
+            auto [key, r] = heads.top();
+            heads.pop();
+            if (!any || key != last) next->append(key);
+            any = true;
+            last = key;
+            if (cursor[r] != limit[r]) heads.push({ *cursor[r]++, r });
+        }
+        level = move(next);
+    }
+
+    primes.insert(primes.end(), found.begin(), found.end());
+    return true;
+}
+
+#endif
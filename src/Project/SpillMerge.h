@@ -0,0 +1,43 @@
+// SpillMerge.h
+#ifndef SPILLMERGE_H
+#define SPILLMERGE_H
+
+#include "Term.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Tabular merge rounds for functions whose levels do not fit in memory.
+// A level is a file of sorted cube keys (dashes, number of ones, bits) that
+// is memory-mapped for its round; a cube's partners are found by binary
+// search in the next group of the same dash pattern. Merged cubes collect in
+// a budget-sized buffer that is sorted and written out as a run file when
+// full, and the runs are merged, dropping duplicates, into the next level's
+// file. No cover lists are kept: the minterms of a cube are its points.
+// Files are unlinked as soon as they are created, so nothing is left behind.
+// Only the levels are on disk: the primes are returned in memory, each with
+// its coveredMinterms, and are not counted against the budget.
+class SpillMerge {
+public:
+    // directory "" uses $TMPDIR, or /tmp
+    SpillMerge(int numVariables, size_t memoryBudget, const string &directory = "");
+    // False where memory-mapped files are not available
+    static bool supported();
+    // Runs every remaining round starting from the given level and appends
+    // the primes, each level ordered by number of ones then binary as the
+    // bitmap sweep does. When interrupted() returns true the current
+    // level's cubes are appended as they are and the merge stops. Returns
+    // false, leaving primes untouched, if a spill file cannot be written.
+    bool run(const vector<uint32_t> &bits, const vector<uint32_t> &dashes, vector<Term> &primes,
+             const function<bool()> &interrupted);
+
+private:
+    int numVariables;
+    size_t bufferKeys; // merged cubes held in memory before a run is written
+    string directory;
+};
+
+#endif // SPILLMERGE_H
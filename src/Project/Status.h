@@ -0,0 +1,34 @@
+// Status.h
+#ifndef STATUS_H
+#define STATUS_H
+
+// Result codes shared by Expression and the library entry points, so an
+// embedding caller never has to parse messages or survive an exit().
+enum class Status {
+    Ok,
+    FileError,
+    InvalidVariableCount,
+    InvalidTerm,
+    MixedTermTypes,
+    TermConflict,
+    UnknownTermType,
+    InvalidTermCount,
+    AlwaysOne
+};
+
+inline const char* statusName(Status status) {
+    switch (status) {
+        case Status::Ok: return "ok";
+        case Status::FileError: return "file error";
+        case Status::InvalidVariableCount: return "invalid number of variables";
+        case Status::InvalidTerm: return "invalid term";
+        case Status::MixedTermTypes: return "mixed term types";
+        case Status::TermConflict: return "term conflict";
+        case Status::UnknownTermType: return "unknown term type";
+        case Status::InvalidTermCount: return "invalid number of terms";
+        case Status::AlwaysOne: return "function is always one";
+    }
+    return "unknown";
+}
+
+#endif // STATUS_H
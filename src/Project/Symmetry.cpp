@@ -0,0 +1,273 @@
+#include "Symmetry.h"
+#include "CoverSearch.h"
+#include "GreedyCover.h"
+#include "Term.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_set>
+
+using namespace std;
+
+static int valueRank(char c) {
+    return c == '0' ? 0 : c == '-' ? 1 : 2;
+}
+
+Symmetry::Symmetry(int numVariables, const vector<int> &onSet, const vector<int> &dcSet)
+    : numVariables(numVariables), onSet(onSet) {
+    size_t words = ((size_t(1) << numVariables) + 63) / 64;
+    on.assign(words, 0);
+    care.assign(words, 0);
+    for (int x : onSet) on[x >> 6] |= uint64_t(1) << (x & 63);
+    care = on;
+    for (int x : dcSet) care[x >> 6] |= uint64_t(1) << (x & 63);
+
+    // Union-find over the variables; a pair already joined through a third
+    // variable needs no test of its own
+    vector<int> parent(numVariables);
+    iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int v) {
+        while (parent[v] != v) v = parent[v] = parent[parent[v]];
+        return v;
+    };
+    for (int a = 0; a < numVariables; a++)
+        for (int b = a + 1; b < numVariables; b++)
+            if (find(a) != find(b) && swapInvariant(a, b)) parent[find(b)] = find(a);
+
+    vector<vector<int>> classes(numVariables);
+    for (int v = 0; v < numVariables; v++) classes[find(v)].push_back(v);
+    for (auto &group : classes)
+        if (group.size() > 1) groups.push_back(group);
+}
+
+bool Symmetry::swapInvariant(int a, int b) const {
+    uint32_t bitA = 1u << (numVariables - 1 - a), bitB = 1u << (numVariables - 1 - b);
+    auto test = [](const vector<uint64_t> &set, uint32_t x) { return (set[x >> 6] >> (x & 63)) & 1; };
+    // Points with a = 0 and b = 1 against their mirror with a = 1 and b = 0
+    for (uint32_t x = 0; x < (1u << numVariables); x++) {
+        if ((x & bitA) || !(x & bitB)) continue;
+        uint32_t y = x ^ bitA ^ bitB;
+        if (test(on, x) != test(on, y) || test(care, x) != test(care, y)) return false;
+    }
+    return true;
+}
+
+bool Symmetry::canonical(const string &cube) const {
+    for (const auto &group : groups)
+        for (size_t i = 1; i < group.size(); i++)
+            if (valueRank(cube[group[i - 1]]) > valueRank(cube[group[i]])) return false;
+    return true;
+}
+
+string Symmetry::canonicalForm(const string &cube) const {
+    string result = cube;
+    for (const auto &group : groups) {
+        string values;
+        for (int v : group) values += cube[v];
+        sort(values.begin(), values.end(), [](char x, char y) { return valueRank(x) < valueRank(y); });
+        for (size_t i = 0; i < group.size(); i++) result[group[i]] = values[i];
+    }
+    return result;
+}
+
+vector<string> Symmetry::representativePrimes(const CancelToken *cancel) {
+    // A canonical prime with its dashes set to 0 is a canonical point, so
+    // those points are the only seeds needed
+    PrimeGrower grower(numVariables, care);
+    vector<PrimeGrower::Cube> cubes;
+    auto keep = [&](uint32_t bits, uint32_t dashes) { return canonical(Term::unpack(bits, dashes, numVariables)); };
+    for (uint32_t x = 0; x < (1u << numVariables); x++) {
+        if (!grower.inCare(x) || !canonical(Term::unpack(x, 0, numVariables))) continue;
+        if (cancel && cancel->stopRequested()) break;
+        grower.growPrimes(x, cubes, keep);
+    }
+    vector<string> primes;
+    for (const auto &[bits, dashes] : cubes) primes.push_back(Term::unpack(bits, dashes, numVariables));
+    return primes;
+}
+
+vector<string> Symmetry::expand(const vector<string> &cubes) const {
+    vector<string> result;
+    unordered_set<string> seen;
+    for (const auto &cube : cubes) {
+        // Distinct arrangements of every group's values, one group at a time
+        vector<string> images = { canonicalForm(cube) };
+        for (const auto &group : groups) {
+            vector<string> next;
+            for (const auto &image : images) {
+                string values;
+                for (int v : group) values += image[v];
+                sort(values.begin(), values.end());
+                do {
+                    string arranged = image;
+                    for (size_t i = 0; i < group.size(); i++) arranged[group[i]] = values[i];
+                    next.push_back(arranged);
+                } while (next_permutation(values.begin(), values.end()));
+            }
+            images.swap(next);
+        }
+        for (auto &image : images)
+            if (seen.insert(image).second) result.push_back(move(image));
+    }
+    return result;
+}
+
+// Covers in one orbit get the same key: the least sorted image over the
+// permutations that order every group's variables by a signature (the
+// variable's value in each cube, next to that cube's canonical form). The
+// signature moves with the variable, so only variables with equal
+// signatures are left to try in every order. Past 5040 such orders a single
+// one is used; covers of one orbit may then be kept more than once, but
+// covers of different orbits are never joined. Cubes are packed two bits
+// per variable so an image is a short sort of integers.
+string Symmetry::orbitKey(const vector<string> &cover) const {
+    auto pack = [&](const string &cube) {
+        uint64_t packed = 0;
+        for (int v = 0; v < numVariables; v++) packed = packed << 2 | valueRank(cube[v]);
+        return packed;
+    };
+    vector<uint64_t> forms;
+    for (const auto &cube : cover) forms.push_back(pack(canonicalForm(cube)));
+
+    // Position group[i] reads the variable with the i-th least signature;
+    // a run of equal signatures is a cell whose variables can go in any order
+    vector<int> source(numVariables); // position -> variable read there
+    iota(source.begin(), source.end(), 0);
+    vector<vector<int>> cellPositions, cellSources;
+    size_t permutations = 1;
+    for (const auto &group : groups) {
+        vector<pair<vector<uint64_t>, int>> signatures;
+        for (int v : group) {
+            vector<uint64_t> signature;
+            for (size_t c = 0; c < cover.size(); c++) signature.push_back(forms[c] << 2 | valueRank(cover[c][v]));
+            sort(signature.begin(), signature.end());
+            signatures.push_back({ signature, v });
+        }
+        sort(signatures.begin(), signatures.end());
+        for (size_t begin = 0, end; begin < group.size(); begin = end) {
+            for (end = begin; end < group.size() && signatures[end].first == signatures[begin].first; end++)
+                source[group[end]] = signatures[end].second;
+            if (end - begin < 2) continue;
+            cellPositions.emplace_back(group.begin() + begin, group.begin() + end);
+            cellSources.emplace_back();
+            for (size_t i = begin; i < end; i++) cellSources.back().push_back(signatures[i].second);
+            sort(cellSources.back().begin(), cellSources.back().end());
+            for (size_t k = 2; k <= end - begin && permutations <= 5040; k++) permutations *= k;
+        }
+    }
+    if (permutations > 5040) {
+        cellPositions.clear();
+        cellSources.clear();
+    }
+
+    vector<uint64_t> best, image(cover.size());
+    // Odometer over the orders of every cell
+    while (true) {
+        for (size_t k = 0; k < cellPositions.size(); k++)
+            for (size_t i = 0; i < cellPositions[k].size(); i++) source[cellPositions[k][i]] = cellSources[k][i];
+        for (size_t c = 0; c < cover.size(); c++) {
+            uint64_t packed = 0;
+            for (int p = 0; p < numVariables; p++) packed = packed << 2 | valueRank(cover[c][source[p]]);
+            image[c] = packed;
+        }
+        sort(image.begin(), image.end());
+        if (best.empty() || image < best) best = image;
+
+        size_t k = 0;
+        while (k < cellSources.size() && !next_permutation(cellSources[k].begin(), cellSources[k].end())) k++;
+        if (k == cellSources.size()) break;
+    }
+    return string(reinterpret_cast<const char *>(best.data()), best.size() * sizeof(uint64_t));
+}
+
+vector<vector<string>> Symmetry::covers(const vector<string> &primes, size_t maxSolutions, ThreadPool *pool,
+                                        const CancelToken *cancel, bool &exact) const {
+    vector<uint32_t> bits(primes.size()), dashes(primes.size());
+    for (size_t c = 0; c < primes.size(); c++) Term::pack(primes[c], bits[c], dashes[c]);
+
+    vector<vector<int>> rows(onSet.size());
+    for (size_t r = 0; r < onSet.size(); r++)
+        for (size_t c = 0; c < primes.size(); c++)
+            if (((onSet[r] ^ bits[c]) & ~dashes[c]) == 0) rows[r].push_back(c);
+
+    // The canonical on-set point with the most primes only takes the
+    // canonical ones among them
+    size_t pinned = rows.size();
+    for (size_t r = 0; r < rows.size(); r++)
+        if (canonical(Term::unpack(onSet[r], 0, numVariables)) &&
+            (pinned == rows.size() || rows[r].size() > rows[pinned].size()))
+            pinned = r;
+    if (pinned < rows.size()) {
+        auto &row = rows[pinned];
+        row.erase(remove_if(row.begin(), row.end(), [&](int c) { return !canonical(primes[c]); }), row.end());
+    }
+
+    // Reduce to the cyclic core, as the Table does: a row left with a
+    // single prime settles it, and a prime covering a subset of another's
+    // open rows is dropped. The search gets what is left.
+    vector<int> essential;
+    vector<uint8_t> dropped(primes.size(), 0);
+    vector<vector<int>> open = move(rows);
+    for (bool changed = true; changed && !open.empty();) {
+        changed = false;
+        vector<uint8_t> taken(primes.size(), 0);
+        for (const auto &row : open)
+            if (row.size() == 1 && !taken[row[0]]) {
+                taken[row[0]] = 1;
+                essential.push_back(row[0]);
+                changed = true;
+            }
+        vector<vector<int>> left;
+        for (auto &row : open)
+            if (none_of(row.begin(), row.end(), [&](int c) { return taken[c]; })) left.push_back(move(row));
+        open.swap(left);
+
+        map<int, vector<int>> covered; // prime -> open rows, ascending
+        for (size_t r = 0; r < open.size(); r++)
+            for (int c : open[r]) covered[c].push_back(int(r));
+        for (auto a = covered.begin(); a != covered.end(); ++a)
+            for (auto b = covered.begin(); b != covered.end(); ++b) {
+                if (a == b || dropped[b->first] || b->second.size() < a->second.size()) continue;
+                // Of two primes with the same rows the later one goes
+                if (b->second.size() == a->second.size() && b->first > a->first) continue;
+                if (includes(b->second.begin(), b->second.end(), a->second.begin(), a->second.end())) {
+                    dropped[a->first] = 1;
+                    changed = true;
+                    break;
+                }
+            }
+        for (auto &row : open)
+            row.erase(remove_if(row.begin(), row.end(), [&](int c) { return dropped[c]; }), row.end());
+    }
+
+    vector<vector<int>> chosen = { vector<int>() };
+    if (!open.empty()) {
+        chosen[0] = GreedyCover::solve(open);
+        if (GreedyCover::preferred(open)) {
+            exact = false;
+        } else {
+            CoverSearch solver(open);
+            solver.allCovers = maxSolutions != 1;
+            vector<vector<int>> best = solver.solve(pool, chosen[0], cancel);
+            if (!best.empty()) chosen = best;
+            if (!solver.complete()) exact = false;
+        }
+    }
+    for (auto &columns : chosen) columns.insert(columns.begin(), essential.begin(), essential.end());
+
+    vector<vector<string>> result;
+    unordered_set<string> orbits;
+    for (const auto &columns : chosen) {
+        // Past the deadline the orbits not seen yet are left out
+        if (cancel && cancel->stopRequested() && !result.empty()) {
+            exact = false;
+            break;
+        }
+        vector<string> cover;
+        for (int c : columns) cover.push_back(primes[c]);
+        if (!orbits.insert(orbitKey(cover)).second) continue;
+        result.push_back(cover);
+        if (result.size() == maxSolutions) break;
+    }
+    return result;
+}
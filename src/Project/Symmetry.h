@@ -0,0 +1,55 @@
+// Symmetry.h
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "CancelToken.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Groups of interchangeable inputs. Variables a and b are symmetric when
+// swapping them maps every on-set point to an on-set point and every
+// don't-care to a don't-care; swaps compose, so the relation is an
+// equivalence and its classes are the groups. Counters, majority and
+// threshold functions are symmetric in all of their inputs.
+//
+// Permuting a group maps primes to primes and minimal covers to minimal
+// covers, so the function only has to be solved up to those permutations:
+// primes are grown from the canonical points alone (within every group the
+// 0s before the 1s) and kept when canonical (0s, then dashes, then 1s),
+// and the cover search pins one on-set point to its canonical primes,
+// which every orbit of covers has a member meeting.
+class Symmetry {
+public:
+    Symmetry(int numVariables, const vector<int> &onSet, const vector<int> &dcSet);
+
+    // Groups of two or more variables (0 is A), ascending
+    vector<vector<int>> groups;
+
+    // One prime per orbit, in canonical form
+    vector<string> representativePrimes(const CancelToken *cancel = nullptr);
+    // Every permutation of the given cubes within the groups, without repeats
+    vector<string> expand(const vector<string> &cubes) const;
+    // Minimum covers built from primes (every prime of the function), at most
+    // one per orbit and at most maxSolutions of them (0 = all). exact is
+    // cleared when the search was stopped or too large for an exact answer.
+    vector<vector<string>> covers(const vector<string> &primes, size_t maxSolutions, ThreadPool *pool,
+                                  const CancelToken *cancel, bool &exact) const;
+
+    bool canonical(const string &cube) const;
+    // The cube with every group sorted into canonical order
+    string canonicalForm(const string &cube) const;
+
+private:
+    bool swapInvariant(int a, int b) const;
+    string orbitKey(const vector<string> &cover) const;
+
+    int numVariables;
+    vector<int> onSet;
+    vector<uint64_t> on, care; // one bit per point
+};
+
+#endif // SYMMETRY_H
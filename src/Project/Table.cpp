@@ -1,140 +1,331 @@
 #include "Table.h"
 #include "Term.h"
+#include "Adjacency.h"
+#include "BitmapEngine.h"
+#include "ConsensusEngine.h"
+#include "CoverSearch.h"
+#include "GreedyCover.h"
+#include "SpillMerge.h"
+#include "Trace.h"
 #include "verilog.h"
 #include <iostream>
 #include <set>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <climits>
+#include <deque>
+#include <functional>
+#include <atomic>
 
 using namespace std;
 
-Table::Table(vector<Term>& minterms, vector<Term>& dontCares) {
+Table::Table(vector<Term>& minterms, vector<Term>& dontCares, const vector<string>& cubes) : out(cout), writeVerilog(true) {
+    load(minterms, dontCares, cubes);
+    generatePrimeImplicants();
+}
+
+Table::Table(ostream &log, bool writeVerilog) : out(log), writeVerilog(writeVerilog) {}
+
+void Table::reset() {
+    terms.clear();
+    seedCubes.clear();
+    primeImplicants.clear();
+    dont_cares.clear();
+    EPI.clear();
+    remainingPI.clear();
+    CoverageChart.clear();
+    reducedChart.clear();
+    AllExpressions.clear();
+    exact = true;
+    minimalSolutions.clear();
+    uniquePIs.clear();
+    selections.clear();
+    C_m.clear();
+    piActive.clear();
+    piSelected.clear();
+    piMinterms.clear();
+    solutions.clear();
+}
+
+void Table::load(const vector<Term>& minterms, const vector<Term>& dontCares, const vector<string>& cubes) {
     // Combine minterms and don't-cares
     terms = minterms;
+    seedCubes = cubes;
     terms.insert(terms.end(), dontCares.begin(), dontCares.end());
     
-    // Store don't care values
+    // Store don't care values, sorted for binary search
     for (const auto& dc : dontCares) {
         dont_cares.push_back(dc.value);
     }
-    
-    generatePrimeImplicants();
+    sort(dont_cares.begin(), dont_cares.end());
 }
 
 void Table::generatePrimeImplicants() {
-    vector<vector<Term>> groups(21); // Assuming max 20 variables
-    set<string> visited;
-    
+    TraceSpan span("generatePrimeImplicants", terms.size());
+    int numVariables = terms.empty() ? 0 : terms[0].binary.size();
+    if (!seedCubes.empty() && !terms.empty() && piEngine == PIEngine::Auto && !memoryBudget) {
+        // Primes grow from the input cubes; minterms given on their own
+        // join them as single-point cubes
+        vector<uint32_t> bits, dashes;
+        vector<uint8_t> inCube(size_t(1) << numVariables, 0);
+        for (const auto &cube : seedCubes) {
+            uint32_t cubeBits, cubeDashes;
+            Term::pack(cube, cubeBits, cubeDashes);
+            bits.push_back(cubeBits);
+            dashes.push_back(cubeDashes);
+            uint32_t sub = 0;
+            do {
+                inCube[cubeBits | sub] = 1;
+                sub = (sub - cubeDashes) & cubeDashes;
+            } while (sub != 0);
+        }
+        for (const auto &term : terms) {
+            if (inCube[term.value]) continue;
+            bits.push_back(term.value);
+            dashes.push_back(0);
+        }
+        // Single-point seeds make consensus quadratic in the minterms; with
+        // too many of them the points are merged as usual
+        if (ConsensusEngine::preferred(dashes)) {
+            if (!ConsensusEngine::generate(numVariables, bits, dashes, primeImplicants, cancel)) interrupted();
+            return;
+        }
+    }
+    bool bitmap = piEngine == PIEngine::Bitmap ||
+        (piEngine == PIEngine::Auto && BitmapEngine::preferred(numVariables, terms.size()));
+    // The bitmap sweep declines (and we fall back) if it would not fit in memory
+    size_t bitmapLimit = memoryBudget ? memoryBudget : size_t(1) << 30;
+    if (bitmap && !terms.empty() && BitmapEngine::generate(numVariables, terms, primeImplicants,
+                                                           bitmapLimit, cancel))
+        return;
+
+    MergeLevel *current = &levels[0];
+    MergeLevel *next = &levels[1];
+
     // Group terms by the number of 1s in their binary representation
+    current->clear();
+    current->groupStart.assign(22, 0);
+    for (const auto &term : terms)
+        current->groupStart[Term::countOnes(term.binary) + 1]++;
+    for (size_t g = 1; g < current->groupStart.size(); g++)
+        current->groupStart[g] += current->groupStart[g - 1];
+    current->bits.resize(terms.size());
+    current->dashes.resize(terms.size());
+    current->coverStart.resize(terms.size());
+    current->coverCount.assign(terms.size(), 1);
+    current->cover.resize(terms.size());
+    uint32_t fill[22];
+    copy(current->groupStart.begin(), current->groupStart.end(), fill);
     for (const auto &term : terms) {
-        int ones = Term::countOnes(term.binary);
-        groups[ones].push_back(term);
-    }
-    
+        uint32_t i = fill[Term::countOnes(term.binary)]++;
+        Term::pack(term.binary, current->bits[i], current->dashes[i]);
+        current->coverStart[i] = i;
+        current->cover[i] = term.value;
+    }
+
+    // Neighbours in a large group are looked up rather than scanned, by a
+    // kernel specialized on the variable count
+    const LookupKernel lookup = lookupKernel(numVariables);
+    const size_t lookupGroup = 48 * size_t(max(numVariables, 1));
+
+    // Once the merge no longer fits the budget the remaining rounds run from
+    // spill files, starting again from the current level; the in-memory
+    // merge carries on if they fail
+    bool spillable = memoryBudget && SpillMerge::supported();
+    auto spill = [&] {
+        if (!SpillMerge(numVariables, memoryBudget, spillDirectory)
+                 .run(current->bits, current->dashes, primeImplicants, [this] { return interrupted(); })) {
+            spillable = false;
+            return false;
+        }
+        levels[0] = MergeLevel();
+        levels[1] = MergeLevel();
+        vector<uint64_t>().swap(seenCubes);
+        levelIndex = CubeIndex();
+        return true;
+    };
+
     bool merged = true;
-    while (merged) {
+    bool stopped = false;
+    while (merged && !stopped) {
+        TraceSpan round("merge round", current->size());
+        // A next level at least as large as this one would not fit
+        if (spillable && 2 * current->bytes() > memoryBudget && spill()) return;
         merged = false;
-        vector<vector<Term>> newGroups(21);
-        set<string> used;
-        
-        // Try to merge terms from adjacent groups
-        for (size_t i = 0; i < groups.size() - 1; i++) {
-            for (const auto &term1 : groups[i]) {
-                for (const auto &term2 : groups[i + 1]) {
-                    if (Term::canCombine(term1, term2)) {
-                        // Create a new term from the combination
-                        Term newTerm(-1, term1.binary.size());
-                        newTerm.binary = Term::combineTerms(term1, term2);
-                        
-                        // Combine covered minterms
-                        newTerm.coveredMinterms = term1.coveredMinterms;
-                        newTerm.coveredMinterms.insert(
-                            newTerm.coveredMinterms.end(), 
-                            term2.coveredMinterms.begin(), 
-                            term2.coveredMinterms.end()
-                        );
-                        
-                        // Add to new groups if not already visited
-                        if (visited.find(newTerm.binary) == visited.end()) {
-                            newGroups[i].push_back(newTerm);
-                            visited.insert(newTerm.binary);
-                        }
-                        
-                        // Mark terms as used
-                        used.insert(term1.binary);
-                        used.insert(term2.binary);
-                        merged = true;
-                    }
+        bool overflow = false;
+        next->clear();
+        mergedFlags.assign(current->size(), 0);
+        matches.resize(current->size());
+        size_t seenCount = 0;
+        size_t seenSize = 1024;
+        while (seenSize < 2 * current->size()) seenSize *= 2;
+        seenCubes.assign(seenSize, ~uint64_t(0));
+
+        // Try to merge terms from adjacent groups; merges of group g only
+        // land in new group g, so the next level is filled in group order
+        const auto &start = current->groupStart;
+        bool indexed = false;
+        for (size_t g = 0; g + 1 < 21 && !overflow; g++) {
+            if (interrupted()) {
+                stopped = true;
+                break;
+            }
+            next->groupStart.push_back(next->size());
+            uint32_t neighbours = start[g + 1];
+            bool useLookup = lookup && start[g + 2] - neighbours > lookupGroup;
+            if (useLookup && !indexed) {
+                levelIndex.build(current->bits.data(), current->dashes.data(), current->size());
+                indexed = true;
+            }
+            for (uint32_t k = start[g]; k < start[g + 1]; k++) {
+                size_t found = useLookup
+                    ? lookup(current->bits[k], current->dashes[k], levelIndex, neighbours, start[g + 2],
+                             matches.data())
+                    : findAdjacent(current->bits[k], current->dashes[k],
+                                   current->bits.data() + neighbours,
+                                   current->dashes.data() + neighbours,
+                                   start[g + 2] - neighbours, matches.data());
+                for (size_t m = 0; m < found; m++) {
+                    uint32_t j = neighbours + matches[m];
+                    // Mark terms as used
+                    mergedFlags[k] = mergedFlags[j] = 1;
+                    merged = true;
+
+                    // The cube with fewer ones carries the merged bits
+                    uint32_t bits = current->bits[k];
+                    uint32_t dashes = current->dashes[k] | (bits ^ current->bits[j]);
+                    if (!insertSeen(uint64_t(dashes) << 32 | bits, seenCount)) continue;
+
+                    // Combine covered minterms
+                    next->add(bits, dashes);
+                    const int *cover = current->cover.data();
+                    next->cover.insert(next->cover.end(), cover + current->coverStart[k],
+                                       cover + current->coverStart[k] + current->coverCount[k]);
+                    next->cover.insert(next->cover.end(), cover + current->coverStart[j],
+                                       cover + current->coverStart[j] + current->coverCount[j]);
+                    next->coverCount.back() = current->coverCount[k] + current->coverCount[j];
+                }
+                // The next level outgrew the budget part way through
+                if (spillable && current->bytes() + next->bytes() + seenCubes.size() * sizeof(uint64_t) >
+                                     memoryBudget) {
+                    overflow = true;
+                    break;
                 }
             }
         }
-        
-        // Collect prime implicants (terms that weren't merged)
-        for (const auto &group : groups) {
-            for (const auto &term : group) {
-                if (used.find(term.binary) == used.end()) {
-                    primeImplicants.push_back(term);
-                    visited.insert(term.binary);
-                }
+        if (overflow) {
+            if (spill()) return;
+            merged = true; // redo the round in memory
+            continue;
+        }
+        next->groupStart.push_back(next->size());
+        next->groupStart.push_back(next->size());
+
+        // Collect prime implicants (terms that weren't merged). When stopped,
+        // every cube of this level is kept: together with the primes found
+        // so far they still cover the function, though not all are prime.
+        for (uint32_t k = 0; k < current->size(); k++) {
+            if (mergedFlags[k] && !stopped) continue;
+            const int *cover = current->cover.data() + current->coverStart[k];
+            if (current->dashes[k] == 0) {
+                primeImplicants.emplace_back(cover[0], numVariables);
+                continue;
             }
+            Term prime(-1, numVariables);
+            prime.binary = Term::unpack(current->bits[k], current->dashes[k], numVariables);
+            prime.coveredMinterms.assign(cover, cover + current->coverCount[k]);
+            primeImplicants.push_back(move(prime));
         }
-        
+
         // Update groups for next iteration
-        groups = newGroups;
+        swap(current, next);
     }
 }
 
+// True once a stop was requested; the run then finishes with what it has
+bool Table::interrupted() {
+    if (cancel && cancel->stopRequested()) exact = false;
+    return !exact;
+}
+
+bool Table::insertSeen(uint64_t key, size_t &seenCount) {
+    if (2 * (seenCount + 1) > seenCubes.size()) {
+        // Grow and rehash; only reached by levels larger than the last one
+        vector<uint64_t> old;
+        old.swap(seenCubes);
+        seenCubes.assign(old.size() * 2, ~uint64_t(0));
+        seenCount = 0;
+        for (uint64_t cube : old)
+            if (cube != ~uint64_t(0)) insertSeen(cube, seenCount);
+    }
+    size_t mask = seenCubes.size() - 1;
+    size_t i = size_t((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+    while (seenCubes[i] != ~uint64_t(0)) {
+        if (seenCubes[i] == key) return false;
+        i = (i + 1) & mask;
+    }
+    seenCubes[i] = key;
+    seenCount++;
+    return true;
+}
+
+void MergeLevel::clear() {
+    bits.clear();
+    dashes.clear();
+    coverStart.clear();
+    coverCount.clear();
+    cover.clear();
+    groupStart.clear();
+}
+
+void MergeLevel::add(uint32_t cubeBits, uint32_t cubeDashes) {
+    bits.push_back(cubeBits);
+    dashes.push_back(cubeDashes);
+    coverStart.push_back(cover.size());
+    coverCount.push_back(0);
+}
+
 void Table::printPrimeImplicants() {
-    cout<< "----------------------------------------------------------------------------------------------"<<endl;
-    cout << "Print Prime implicants \n";
-    cout << "PIs \t\t\t\t\t-> Binary\t\t\t\t\t-> String \n";
+    out<< "----------------------------------------------------------------------------------------------"<<endl;
+    out << "Print Prime implicants \n";
+    out << "PIs \t\t\t\t\t-> Binary\t\t\t\t\t-> String \n";
     for (const auto &pi : primeImplicants) {
         for (auto &m : pi.coveredMinterms){
             if(m == pi.coveredMinterms[pi.coveredMinterms.size()-1])
-            cout<<m;
+            out<<m;
             else
-            cout<<m << " & ";
+            out<<m << " & ";
         }
-        cout<< "\t\t\t\t\t-> " << pi.binary <<"\t\t\t\t\t-> " << pi.toExpression() << endl;
+        out<< "\t\t\t\t\t-> " << pi.binary <<"\t\t\t\t\t-> " << pi.toExpression() << endl;
         
 
 }
-cout<< "----------------------------------------------------------------------------------------------"<<endl;
+out<< "----------------------------------------------------------------------------------------------"<<endl;
 }
 // Generating EPIs from the table of PI after forming them
 void Table::EPIgeneration() {
+    TraceSpan selection("EPI selection", primeImplicants.size());
     // coverage chart
-  
-    for (auto &pi : primeImplicants) {
-        for (auto &m : pi.coveredMinterms) {
-            if (find(dont_cares.begin(), dont_cares.end(), m) == dont_cares.end())
-            CoverageChart[m].push_back(pi);
+    piActive.assign(primeImplicants.size(), 1);
+    piSelected.assign(primeImplicants.size(), 0);
+    for (uint32_t p = 0; p < primeImplicants.size(); p++) {
+        for (auto &m : primeImplicants[p].coveredMinterms) {
+            if (!isDontCare(m))
+            CoverageChart[m].push_back(p);
         }
     }
         for (auto &[m, pi_list] : CoverageChart) {
 
-        // Skip don't care terms when identifying EPIs
-        if (find(dont_cares.begin(), dont_cares.end(), m) != dont_cares.end()) {
-            cout<< "dontcare skipped : "<< m << endl;
-        continue;
-        }
-
         if (pi_list.size() == 1) {
-            Term essentialPI = pi_list[0];
+            uint32_t essential = pi_list[0];
+            const Term &essentialPI = primeImplicants[essential];
             
-                // avoid duplicates
-            bool already_included = false;
-            for (const auto &epi : EPI) {
-                if (epi.binary == essentialPI.binary) {
-                    already_included = true;
-                    break;
-                }
-                
-            }
-            if (!already_included) {
-                EPI.push_back(essentialPI);
-                cout << "Essential Prime Implicant: " << essentialPI.toExpression() << endl;
+            // avoid duplicates
+            if (!piSelected[essential]) {
+                piSelected[essential] = 1;
+                EPI.push_back(essential);
+                out << "Essential Prime Implicant: " << essentialPI.toExpression() << endl;
                 
                 
                 // Mark all minterms covered by this EPI
@@ -145,24 +336,20 @@ void Table::EPIgeneration() {
             }
         }
    }
-cout<< "----------------------------------------------------------------------------------------------"<<endl;
+out<< "----------------------------------------------------------------------------------------------"<<endl;
+    selection.end();
 
    // After extracting all the EPIs, process remaining PI is generated to get the remaining PIs
   processRemainingPI();
   // Applying dominance rule on the remaining PIs
   applyDominanceRules();
 
- // Check and get all the remaining minterms after the dominance rule to be applied in the Petrick method
- for (auto &[m, _] : reducedChart) {
- }
- // extracting Bestfit PIs from the remaining PIs after domination rule
-   BestfitPI();
-   cout<<"Remaining PIs after domination rule\n";
+   out<<"Remaining PIs after domination rule\n";
    if(remainingPI.size()== 0)
-   cout<<"There is not remaining PI \n";
+   out<<"There is not remaining PI \n";
    else
-   for(auto & rem: remainingPI){
-    cout<<rem.toExpression()<<endl;
+   for(auto rem: remainingPI){
+    out<<primeImplicants[rem].toExpression()<<endl;
    }
      if (!reducedChart.empty()) {
          // Apply Petrick's method for the remaining uncovered minterms
@@ -170,373 +357,371 @@ cout<< "------------------------------------------------------------------------
       }
 
     // Generate the final expression
-    cout<< "\n----------------------------------------------------------------------------------------------\n";
-    cout << "\t\t\t\tFinal Expression with EPIs and bestfit PIs\n";
+    out<< "\n----------------------------------------------------------------------------------------------\n";
+    out << "\t\t\t\tFinal Expression with EPIs\n";
     for (size_t i = 0; i < EPI.size(); i++) {
-        if (i > 0) cout << " + ";
-        cout << EPI[i].toExpression();
+        if (i > 0) out << " + ";
+        out << primeImplicants[EPI[i]].toExpression();
     }
-    cout<< "\n----------------------------------------------------------------------------------------------\n";
+    out<< "\n----------------------------------------------------------------------------------------------\n";
 
 FinalExpression();
 }
 
+bool Table::isDontCare(int m) const {
+    return binary_search(dont_cares.begin(), dont_cares.end(), m);
+}
+
+void Table::dropInactivePIs() {
+    remainingPI.erase(remove_if(remainingPI.begin(), remainingPI.end(),
+                                [this](uint32_t p) { return !piActive[p]; }),
+                      remainingPI.end());
+}
+
 void Table::processRemainingPI() {
+    TraceSpan span("processRemainingPI");
     // Clear existing collections
     remainingPI.clear();
     reducedChart.clear();
-    
-    // Create a map to track which minterms each PI covers (after reduction)
+    piMinterms.assign(primeImplicants.size(), vector<int>());
 
     // Process each prime implicant
-    for (auto &pi : primeImplicants) {
-        // Check if this PI is already an EPI
-        bool isEPI = false;
-        for (const auto &epi : EPI) {
-            if (pi.binary == epi.binary) {
-                isEPI = true;
-                break;
-            }
+    for (uint32_t p = 0; p < primeImplicants.size(); p++) {
+        const Term &pi = primeImplicants[p];
+        // EPIs are already part of the cover
+        if (piSelected[p]) {
+            piActive[p] = 0;
+            continue;
         }
-        
-        // If not an EPI, add to remaining PIs and update reduced chart
-        if (!isEPI) {
-            // Add to remaining PI list
-            remainingPI.push_back(pi);
-            cout << "Remaining pI: " << pi.toExpression() << endl;
-            
-            // Track uncovered minterms for this PI
-            set<int> uncoveredMinterms;
-            
-            // Update reduced chart with uncovered minterms
-            for (auto &m : pi.coveredMinterms) {
-                if (C_m.find(m) == C_m.end() && 
-                    find(dont_cares.begin(), dont_cares.end(), m) == dont_cares.end()) {
-                    reducedChart[m].push_back(pi);
-                    uncoveredMinterms.insert(m);
-                }
+
+        // Add to remaining PI list
+        remainingPI.push_back(p);
+        out << "Remaining pI: " << pi.toExpression() << endl;
+
+        // Update reduced chart with uncovered minterms, and remember them
+        // per PI for row dominance
+        for (auto &m : pi.coveredMinterms) {
+            if (C_m.find(m) == C_m.end() && !isDontCare(m)) {
+                piMinterms[p].push_back(m);
             }
-            
-            // Map this PI to its uncovered minterms
-            if (!uncoveredMinterms.empty())
-                piToMinterms[pi.binary] = uncoveredMinterms;
         }
+        sort(piMinterms[p].begin(), piMinterms[p].end());
+        piMinterms[p].erase(unique(piMinterms[p].begin(), piMinterms[p].end()), piMinterms[p].end());
+        for (int m : piMinterms[p])
+            reducedChart[m].push_back(p);
     }
     
     // Print the reduced coverage chart for debugging
-    cout<< "----------------------------------------------------------------------------------------------"<<endl;
-    cout << "\nReduced Coverage Chart\n";
+    out<< "----------------------------------------------------------------------------------------------"<<endl;
+    out << "\nReduced Coverage Chart\n";
     for (auto &[minterm, pis] : reducedChart) {
-        cout << "Minterm " << minterm << " covered by: ";
-        for (auto &pi : pis) {
-            cout << pi.toExpression() << " ";
+        out << "Minterm " << minterm << " covered by: ";
+        for (auto p : pis) {
+            out << primeImplicants[p].toExpression() << " ";
         }
-        cout << endl;
+        out << endl;
     }
-    cout<< "----------------------------------------------------------------------------------------------"<<endl;
+    out<< "----------------------------------------------------------------------------------------------"<<endl;
 }
 
 
+// Reduces the cover table to its cyclic core. Instead of re-comparing every
+// pair of rows and columns until nothing changes, only the rows and columns
+// touched by the last removal are re-examined, and a column left with a
+// single PI makes that PI essential on the spot.
 void Table::applyDominanceRules() {
-    std::cout << "\n\t\t\t\t=== Applying Dominance Rules ===" << std::endl;
-    
-    bool changed;
-    int iteration = 0;
-    do {
-        changed = false;
-        
-        // Apply column dominance first, then row dominance
-    
-        bool colChanged = applyColumnDominance();
-        bool rowChanged = applyRowDominance();
-        
-        changed = colChanged || rowChanged;
-        
-        // If any changes were made, update the coverage chart
-        if (changed) {            
-            // Update the reduced chart based on the remaining PIs
-            for (auto& entry : reducedChart) {
-                // Filter out any PIs that have been removed
-                auto& piList = entry.second;
-                int beforeSize = piList.size();
-                piList.erase(
-                    remove_if(piList.begin(), piList.end(), 
-                        [this](const Term& pi) {
-                            return find(remainingPI.begin(), remainingPI.end(), pi) == remainingPI.end();
-                        }),
-                    piList.end()
-                );
-                int afterSize = piList.size();
-            }
+    TraceSpan span("dominance");
+    out << "\n\t\t\t\t=== Applying Dominance Rules ===" << endl;
+
+    dirtyRows.clear();
+    dirtyColumns.clear();
+    rowQueued.assign(primeImplicants.size(), 0);
+    columnQueued.clear();
+    for (auto& entry : reducedChart)
+        markColumn(entry.first);
+    for (auto p : remainingPI)
+        markRow(p);
+
+    // Every step leaves a valid chart, so a stop just ends the reduction
+    size_t steps = 0;
+    for (; (!dirtyColumns.empty() || !dirtyRows.empty()) && !interrupted(); steps++) {
+        // Columns first: essentials and column dominance shrink the rows
+        if (!dirtyColumns.empty()) {
+            int m = dirtyColumns.front();
+            dirtyColumns.pop_front();
+            columnQueued.erase(m);
+            reduceColumn(m);
+        } else {
+            uint32_t p = dirtyRows.front();
+            dirtyRows.pop_front();
+            rowQueued[p] = 0;
+            reduceRow(p);
         }
-    } while (changed);
+    }
+    dropInactivePIs();
+    span.setArg(steps);
     
-    cout << "Remaining PIs with minterms after domination" << std::endl;
+    out << "Remaining PIs with minterms after domination" << endl;
     for (const auto& entry : reducedChart) {
-        std::cout << "Minterm " << entry.first << " covered by PIs: ";
-        for (const auto& pi : entry.second) {
-            std::cout << pi.toExpression() << " ";
+        out << "Minterm " << entry.first << " covered by PIs: ";
+        for (auto p : entry.second) {
+            out << primeImplicants[p].toExpression() << " ";
         }
-        std::cout << std::endl;
+        out << endl;
     }
     if(!remainingPI.empty()){
-    cout<< "\n----------------------------------------------------------------------------------------------\n";
-    cout<<"Remaining PIs after domination: ";
-    for(auto & rem: remainingPI){
-        if(rem == remainingPI[remainingPI.size()-1])
-        cout << rem.toExpression()<<endl;
+    out<< "\n----------------------------------------------------------------------------------------------\n";
+    out<<"Remaining PIs after domination: ";
+    for(size_t i = 0; i < remainingPI.size(); i++){
+        if(i + 1 == remainingPI.size())
+        out << primeImplicants[remainingPI[i]].toExpression()<<endl;
         else
-        cout<< rem.toExpression()<<" , ";
+        out<< primeImplicants[remainingPI[i]].toExpression()<<" , ";
     }
     }
-    cout<< "\n----------------------------------------------------------------------------------------------\n";
+    out<< "\n----------------------------------------------------------------------------------------------\n";
 }
 
-
-bool Table::applyColumnDominance() {
-    bool changed = false;   
-    // Create a copy of the keys to avoid iterator invalidation
-    vector<int> minterms;
-    for (const auto& entry : reducedChart) {
-        minterms.push_back(entry.first);
-    }
-    
-    // Check each pair of minterms for dominance
-    for (size_t i = 0; i < minterms.size(); ++i) {
-        // Skip if this minterm has been removed
-        if (reducedChart.find(minterms[i]) == reducedChart.end())
-            continue;
-        
-        for (size_t j = 0; j < minterms.size(); ++j) {
-            // Skip self-comparison or if second minterm has been removed
-            if (i == j || reducedChart.find(minterms[j]) == reducedChart.end()) {
-                continue;
-            }
-            
-            // Check if minterm[i]'s PIs include all of minterm[j]'s PIs
-            const auto& piList1 = reducedChart[minterms[i]];
-            const auto& piList2 = reducedChart[minterms[j]];
-            
-            if (includes(piList1.begin(), piList1.end(),
-                         piList2.begin(), piList2.end())) {
-                reducedChart.erase(minterms[i]);
-                changed = true;
-                break;
-            }
-        }
+void Table::markRow(uint32_t p) {
+    if (piActive[p] && !rowQueued[p]) {
+        rowQueued[p] = 1;
+        dirtyRows.push_back(p);
     }
-    
-    return changed;
 }
 
-bool Table::applyRowDominance() {
-    bool changed = false;
-
-    // Create a map of PIs to their covered minterms
-    map<string, set<int>> piToMinterms;
-    for (const auto& pi : remainingPI) {
-        set<int> coveredMinterms;
-        for (const auto& m : pi.coveredMinterms) {
-            if (C_m.find(m) == C_m.end() && 
-                find(dont_cares.begin(), dont_cares.end(), m) == dont_cares.end()) {
-                coveredMinterms.insert(m);
-            }
-        }
-        piToMinterms[pi.binary] = coveredMinterms;
+void Table::markColumn(int m) {
+    if (columnQueued.insert(m).second)
+        dirtyColumns.push_back(m);
+}
+
+void Table::removeRow(uint32_t p) {
+    piActive[p] = 0;
+    for (int m : piMinterms[p]) {
+        auto& piList = reducedChart[m];
+        piList.erase(lower_bound(piList.begin(), piList.end(), p));
+        markColumn(m);
     }
+    piMinterms[p].clear();
+}
 
-    // Check for row dominance
-    for (auto it1 = remainingPI.begin(); it1 != remainingPI.end();) {
-        bool dominated = false;
-        for (auto it2 = remainingPI.begin(); it2 != remainingPI.end(); ++it2) {
-            if (it1 == it2) continue;
+void Table::removeColumn(int m) {
+    auto entry = reducedChart.find(m);
+    for (auto p : entry->second) {
+        auto& minterms = piMinterms[p];
+        minterms.erase(lower_bound(minterms.begin(), minterms.end(), m));
+        markRow(p);
+    }
+    reducedChart.erase(entry);
+}
 
-            const auto& minterms1 = piToMinterms[it1->binary];
-            const auto& minterms2 = piToMinterms[it2->binary];
+void Table::reduceColumn(int m) {
+    auto entry = reducedChart.find(m);
+    if (entry == reducedChart.end() || entry->second.empty()) return;
+    const vector<uint32_t>& piList = entry->second;
+
+    // Only one PI left for this minterm: it belongs to every cover
+    if (piList.size() == 1) {
+        uint32_t p = piList[0];
+        piSelected[p] = 1;
+        EPI.push_back(p);
+        out << "Essential Prime Implicant (after dominance): " << primeImplicants[p].toExpression()
+            << " (only cover of minterm " << m << ")" << endl;
+        for (auto& covered : primeImplicants[p].coveredMinterms)
+            C_m.insert(covered);
+        vector<int> columns = piMinterms[p];
+        for (int c : columns)
+            removeColumn(c);
+        piActive[p] = 0;
+        return;
+    }
 
-            // Check if it2 dominates it1
-            if (includes(minterms2.begin(), minterms2.end(), minterms1.begin(), minterms1.end()) &&
-                minterms1 != minterms2) {
-                it1 = remainingPI.erase(it1);
-                changed = true;
-                dominated = true;
-                break;
-            }
+    // Column dominance against every minterm sharing a PI with this one:
+    // a minterm whose PIs include all of another's is covered for free
+    set<int> neighbours;
+    for (auto p : piList)
+        neighbours.insert(piMinterms[p].begin(), piMinterms[p].end());
+    neighbours.erase(m);
+    for (int other : neighbours) {
+        auto it = reducedChart.find(other);
+        if (it == reducedChart.end()) continue;
+        const vector<uint32_t>& otherList = it->second;
+        if (includes(piList.begin(), piList.end(), otherList.begin(), otherList.end())) {
+            removeColumn(m);
+            return;
         }
-        if (!dominated) ++it1;
+        if (includes(otherList.begin(), otherList.end(), piList.begin(), piList.end()))
+            removeColumn(other);
     }
-    return changed;
 }
 
- // After domination rules, process remaining uncovered minterms
-void Table::BestfitPI() {
-    cout<<"Selecting the best fit PIs after domination rules\n";
-    map<int, Term*> exclusiveCoverage;
-    
-    // First pass: identify minterms covered by only one PI
-    for (auto &[minterm, pi_list] : reducedChart) {
-        // If this minterm is covered by exactly one PI
-        if (pi_list.size() == 1) {
-            exclusiveCoverage[minterm] = &pi_list[0];
-        }
-    }
-    
-   // Second pass: collect unique PIs that have exclusive coverage
-    for (auto &[minterm, pi_ptr] : exclusiveCoverage) {
-        // Check if this PI is already included
-        bool already_included = false;
-        for (const auto &epi : EPI) {
-            if (epi.binary == pi_ptr->binary) {
-                already_included = true;
-                break;
-            }
-        }
-        
-        if (!already_included) {
-            EPI.push_back(*pi_ptr);
-            cout << "Best fit PI: " << pi_ptr->toExpression() 
-                 << " (exclusively covers minterm " << minterm << ")" << endl;
-            
-            // Mark all minterms covered by this PI
-            for (auto &covered : pi_ptr->coveredMinterms)
-                C_m.insert(covered);
-        }
-        // Remove this PI from remainingPI
-        auto it = find_if(remainingPI.begin(), remainingPI.end(), 
-        [&](const Term& t) { return t.binary == pi_ptr->binary; });
-    if (it != remainingPI.end()) {
-      //  cout << "Removing " << it->toExpression() << " from remaining PIs" << endl;
-        remainingPI.erase(it);
+void Table::reduceRow(uint32_t p) {
+    if (!piActive[p]) return;
+    const vector<int>& minterms = piMinterms[p];
+    if (minterms.empty()) {
+        removeRow(p);
+        return;
     }
-    
-    // Update reducedChart by removing covered minterms
-    for (auto &covered : pi_ptr->coveredMinterms) {
-        // Skip don't care terms
-        if (find(dont_cares.begin(), dont_cares.end(), covered) != dont_cares.end()) {
-            continue;
+
+    // A dominating PI must cover every minterm of p, so it is enough to
+    // look at the PIs of p's least shared minterm
+    const vector<uint32_t>* candidates = nullptr;
+    for (int m : minterms) {
+        const vector<uint32_t>& piList = reducedChart[m];
+        if (!candidates || piList.size() < candidates->size()) candidates = &piList;
+    }
+    for (auto q : *candidates) {
+        const vector<int>& other = piMinterms[q];
+        // Strictly larger only: equal PIs are kept as alternative solutions
+        if (q != p && other.size() > minterms.size() &&
+            includes(other.begin(), other.end(), minterms.begin(), minterms.end())) {
+            removeRow(p);
+            return;
         }
-        // Remove the minterm from the reduced chart
-        reducedChart.erase(covered);
-       // cout << "Removed minterm " << covered << " from reduced chart" << endl;
-    }
     }
 }
 
+ // After domination rules, process remaining uncovered minterms
 void Table::PetrickMethod() {
+    TraceSpan span("PetrickMethod", reducedChart.size());
     if (reducedChart.empty()) {
-        cout << "All minterms are covered by Essential Prime Implicants." << endl;
+        out << "All minterms are covered by Essential Prime Implicants." << endl;
         return;
     }
-    cout<< "\n----------------------------------------------------------------------------------------------\n";
-    cout << "\t\t\t\tApplying Petrick's method for remaining minterms" << endl;
-    map<string, int> piToIndex;
-        // Assigning indices to unique prime implicants
+    out<< "\n----------------------------------------------------------------------------------------------\n";
+    out << "\t\t\t\tApplying Petrick's method for remaining minterms" << endl;
+    // Assigning Petrick indices to unique prime implicants
+    vector<int> piToIndex(primeImplicants.size(), -1);
     for (const auto& [minterm, pi_list] : reducedChart) {
-        for (const auto& pi : pi_list) {
-            if (piToIndex.find(pi.binary) == piToIndex.end()) { 
-                piToIndex[pi.binary] = uniquePIs.size();
-                uniquePIs.push_back(pi);
-                for (const auto& [s, i] :piToIndex ) {
-                }
-
-                
+        for (auto p : pi_list) {
+            if (piToIndex[p] < 0) { 
+                piToIndex[p] = uniquePIs.size();
+                uniquePIs.push_back(p);
             }
         }
     }    
-    //Forming Product of Sums expression
-    vector<vector<int>> petricksExpression;
-    
-    for (const auto& [minterm, pi_list] : reducedChart) {
-        vector<int> sum;
-        for (const auto& pi : pi_list) {
-            sum.push_back(piToIndex[pi.binary]);
+    // Split the chart into independent blocks: minterms sharing a PI belong
+    // to the same block, and each block is a Petrick problem of its own, so
+    // the expansion grows with the largest block instead of their product
+    vector<vector<vector<int>>> blocks = splitIntoBlocks(piToIndex);
+    out << "Cover table splits into " << blocks.size() << " independent block(s)" << endl;
+
+    // Auto expands small blocks, searches the larger ones and covers the
+    // ones too big for an exact answer greedily. Under a stop request the
+    // search is the anytime solver: it starts from the greedy cover and
+    // replaces it whenever it finds a smaller one.
+    vector<vector<vector<int>>> blockSolutions(blocks.size());
+    atomic<bool> approximate(false);
+    auto solveBlock = [&](size_t b) {
+        const vector<vector<int>> &block = blocks[b];
+        TraceSpan blockSpan("cover block", block.size());
+        CoverEngine engine = coverEngine;
+        if (engine == CoverEngine::Auto) {
+            if (GreedyCover::preferred(block)) engine = CoverEngine::Greedy;
+            else if (cancel || CoverSearch::preferred(block)) engine = CoverEngine::BranchAndBound;
+            else engine = CoverEngine::Petrick;
         }
-        petricksExpression.push_back(sum);
-    }
-    
-    //Expanding to Sum of Products
-    vector<vector<int>> sop = expandToPetricksSOP(petricksExpression);
-
-// Step 5: Find all minimal term solutions (without considering literal count)
-int minTerms = INT_MAX;
-    
-// First: find the minimum number of terms
-for (const auto& product : sop) {
-    if (product.size() < minTerms) {
-        minTerms = product.size();
-    }
-}
-    
-// Second: collect all solutions with the minimum number of terms
-// (These are all considered equally minimal since we don't care about complement cost)
-for (const auto& product : sop) {
-    if (product.size() == minTerms) {
-        minimalSolutions.push_back(product);
+        if (engine == CoverEngine::Petrick && cancel && cancel->stopRequested())
+            engine = CoverEngine::Greedy;
+
+        if (engine == CoverEngine::Greedy) {
+            blockSolutions[b] = { GreedyCover::solve(block) };
+            approximate = true;
+        } else if (engine == CoverEngine::BranchAndBound) {
+            CoverSearch solver(block);
+            solver.allCovers = allSolutions;
+            blockSolutions[b] = solver.solve(pool, GreedyCover::solve(block), cancel);
+            if (!solver.complete()) approximate = true;
+        } else { //Expanding to Sum of Products, keeping the products with fewest terms
+            blockSolutions[b] = fewestTerms(expandToPetricksSOP(block));
+        }
+    };
+    if (pool && blocks.size() > 1) {
+        vector<function<void()>> jobs;
+        for (size_t b = 0; b < blocks.size(); b++)
+            jobs.push_back([&, b] { solveBlock(b); });
+        pool->runAll(jobs);
+    } else {
+        for (size_t b = 0; b < blocks.size(); b++)
+            solveBlock(b);
+    }
+    if (approximate) {
+        exact = false;
+        out << "Greedy or stopped early: the covers below are valid but not proven minimal" << endl;
+    }
+
+    // Every combination of block solutions is a minimal solution of the
+    // whole table; build them all only when all alternatives were asked for
+    minimalSolutions.push_back({});
+    for (const auto& solutionsOfBlock : blockSolutions) {
+        vector<vector<int>> combined;
+        for (const auto& partial : minimalSolutions) {
+            for (const auto& choice : solutionsOfBlock) {
+                vector<int> product = partial;
+                product.insert(product.end(), choice.begin(), choice.end());
+                combined.push_back(product);
+                if (!allSolutions) break;
+            }
+        }
+        minimalSolutions.swap(combined);
     }
-}
+    for (auto& product : minimalSolutions)
+        sort(product.begin(), product.end());
+    sort(minimalSolutions.begin(), minimalSolutions.end());
 
 // Process all minimal solutions
-cout << "Found " << minimalSolutions.size() << " minimal solutions:" << endl;
+out << "Found " << minimalSolutions.size() << " minimal solutions:" << endl;
 
 // Clear previous selections
 selections.clear();
 
 // Process each minimal solution separately
-vector<vector<Term>> allSolutions;
+vector<vector<uint32_t>> solutionSets;
 
 // Process each minimal solution
 for (size_t solIdx = 0; solIdx < minimalSolutions.size(); solIdx++) {
-    cout << "Solution " << (solIdx + 1) << ":" << endl;
+    out << "Solution " << (solIdx + 1) << ":" << endl;
     
     // Store the PIs for this solution
-    vector<Term> solutionPIs;
+    vector<uint32_t> solutionPIs;
     
     // Process each PI in this solution
     for (int piIdx : minimalSolutions[solIdx]) {
-        Term selectedPI = uniquePIs[piIdx];
-        
-        // Check if already included in EPIs
-        bool alreadyIncluded = false;
-        for (const auto& epi : EPI) {
-            if (epi.binary == selectedPI.binary) {
-                alreadyIncluded = true;
-                break;
-            }
-        }
+        uint32_t selectedPI = uniquePIs[piIdx];
         
-        if (!alreadyIncluded) {
+        // Skip PIs already included in EPIs
+        if (!piSelected[selectedPI]) {
             solutionPIs.push_back(selectedPI);
-            cout << "Prime Implicant in solution " << (solIdx + 1) 
-                 << ": " << selectedPI.toExpression() << endl;
+            out << "Prime Implicant in solution " << (solIdx + 1) 
+                 << ": " << primeImplicants[selectedPI].toExpression() << endl;
         }
     }
     
     // Store this solution
-    allSolutions.push_back(solutionPIs);
+    solutionSets.push_back(solutionPIs);
 }
 
 // Now generate expressions for each solution
-for (size_t i = 0; i < allSolutions.size(); i++) {
+for (size_t i = 0; i < solutionSets.size(); i++) {
     // Clear previous selections
-    selections = allSolutions[i];
+    selections = solutionSets[i];
     
     // Generate and print this expression
-    cout << "Minimized Expression " << (i + 1) << ": ";
+    out << "Minimized Expression " << (i + 1) << ": ";
     
     string expr = "";
     // First add all EPIs
     for (size_t j = 0; j < EPI.size(); j++) {
         if (j > 0 || !expr.empty()) expr += " + ";
-        expr += EPI[j].toExpression();
+        expr += primeImplicants[EPI[j]].toExpression();
     }
     
     // Then add the selected PIs for this solution
-    for (const auto& pi : selections) {
+    for (auto p : selections) {
         if (!expr.empty()) expr += " + ";
-        expr += pi.toExpression();
+        expr += primeImplicants[p].toExpression();
     }
     
-    cout << expr << endl;
+    out << expr << endl;
     
     // Add to AllExpressions map for later use
     vector<string> terms;
@@ -553,7 +738,7 @@ for (size_t i = 0; i < allSolutions.size(); i++) {
     AllExpressions[i] = terms;
 }
 
-cout << "Total minimal solutions found: " << allSolutions.size() << endl;
+out << "Total minimal solutions found: " << solutionSets.size() << endl;
 }
 
 // Count literals in a term (for cost calculation)
@@ -602,6 +787,7 @@ vector<vector<int>> Table::expandToPetricksSOP(const vector<vector<int>>& pos) {
     result.erase(unique(result.begin(), result.end()), result.end());
     
     // Apply absorption law properly
+    vector<vector<int>> minimalResult;
 for (size_t i = 0; i < result.size(); i++) {
     bool isRedundant = false;
     for (size_t j = 0; j < result.size(); j++) {
@@ -620,6 +806,47 @@ for (size_t i = 0; i < result.size(); i++) {
     return minimalResult;
 }
 
+// Keep only the products with the minimum number of terms
+vector<vector<int>> Table::fewestTerms(const vector<vector<int>>& sop) {
+    size_t minTerms = SIZE_MAX;
+    for (const auto& product : sop)
+        minTerms = min(minTerms, product.size());
+    vector<vector<int>> minimal;
+    for (const auto& product : sop)
+        if (product.size() == minTerms) minimal.push_back(product);
+    return minimal;
+}
+
+// Groups the Petrick clauses (one per reducedChart minterm) into blocks that
+// share no PI, using union-find over the Petrick indices
+vector<vector<vector<int>>> Table::splitIntoBlocks(const vector<int>& piToIndex) {
+    vector<int> parent(uniquePIs.size());
+    for (size_t i = 0; i < parent.size(); i++) parent[i] = i;
+    auto root = [&](int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+
+    vector<vector<int>> clauses;
+    for (const auto& [minterm, pi_list] : reducedChart) {
+        vector<int> sum;
+        for (auto p : pi_list) {
+            sum.push_back(piToIndex[p]);
+            parent[root(sum.back())] = root(sum.front());
+        }
+        clauses.push_back(sum);
+    }
+
+    vector<vector<vector<int>>> blocks;
+    map<int, size_t> blockOf;
+    for (auto& clause : clauses) {
+        auto it = blockOf.emplace(root(clause.front()), blocks.size()).first;
+        if (it->second == blocks.size()) blocks.emplace_back();
+        blocks[it->second].push_back(move(clause));
+    }
+    return blocks;
+}
+
 
 void Table::FinalExpression() {
     // Construct base expression from Essential Prime Implicants
@@ -627,78 +854,75 @@ void Table::FinalExpression() {
     vector<string> exp;
     for (size_t i = 0; i < EPI.size(); i++) {
         if (i > 0) base_expr += " + ";
-        base_expr += EPI[i].toExpression();
-        exp.push_back(EPI[i].toExpression());
+        base_expr += primeImplicants[EPI[i]].toExpression();
+        exp.push_back(primeImplicants[EPI[i]].toExpression());
     }
 
     // Process all minimal solutions from Petrick's method
-    cout << "\t\t\tPossible Function Minimizations" << endl;
+    out << "\t\t\tPossible Function Minimizations" << endl;
     
     if (minimalSolutions.empty()) {
         // If no solutions from Petrick's method, just print the EPIs
-        cout << "F = " << base_expr << endl;
+        out << "F = " << base_expr << endl;
         AllExpressions[0] = exp;
+        solutions.push_back(EPI);
         
         // Generate Verilog for the base expression
-        std::string verilogCode = generateVerilogModule(base_expr, "minimized_logic");
-        std::string filename = "minimized_logic.v";
-        std::ofstream outFile(filename);
-        if (outFile.is_open()) {
-            outFile << verilogCode;
-            outFile.close();
-            std::cout << "Generated Verilog module written to " << filename << std::endl;
-        } else {
-            std::cerr << "Failed to open " << filename << " for writing" << std::endl;
+        if (writeVerilog) {
+            std::string verilogCode = generateVerilogModule(base_expr, "minimized_logic");
+            std::string filename = "minimized_logic.v";
+            std::ofstream outFile(filename);
+            if (outFile.is_open()) {
+                outFile << verilogCode;
+                outFile.close();
+                out << "Generated Verilog module written to " << filename << endl;
+            } else {
+                std::cerr << "Failed to open " << filename << " for writing" << endl;
+            }
         }
     } else {
         // Store all possible expressions
-        vector<vector<Term>> allSolutions;
+        vector<vector<uint32_t>> solutionSets;
         
         // Process each minimal solution
         for (size_t solIdx = 0; solIdx < minimalSolutions.size(); solIdx++) {
             // Store the PIs for this solution
-            vector<Term> solutionPIs;
+            vector<uint32_t> solutionPIs;
             
-            // Process each PI in this solution
+            // Process each PI in this solution, skipping those already in EPIs
             for (int piIdx : minimalSolutions[solIdx]) {
-                Term selectedPI = uniquePIs[piIdx];
-                
-                // Check if already included in EPIs
-                bool alreadyIncluded = false;
-                for (const auto& epi : EPI) {
-                    if (epi.binary == selectedPI.binary) {
-                        alreadyIncluded = true;
-                        break;
-                    }
-                }
-                
-                if (!alreadyIncluded) {
+                uint32_t selectedPI = uniquePIs[piIdx];
+                if (!piSelected[selectedPI]) {
                     solutionPIs.push_back(selectedPI);
                 }
             }
             
             // Add this solution to all selections
-            allSolutions.push_back(solutionPIs);
+            solutionSets.push_back(solutionPIs);
         }
         
         // Print each possible function minimization
-        for (size_t i = 0; i < allSolutions.size(); i++) {
+        for (size_t i = 0; i < solutionSets.size(); i++) {
             string expr = base_expr;
             vector<string> terms = exp;  // Start with EPIs
             
             // Add the selected PIs for this solution
-            for (const auto& pi : allSolutions[i]) {
+            for (auto p : solutionSets[i]) {
                 if (!expr.empty()) expr += " + ";
-                expr += pi.toExpression();
-                terms.push_back(pi.toExpression());
+                expr += primeImplicants[p].toExpression();
+                terms.push_back(primeImplicants[p].toExpression());
             }
             
-            cout << "F = " << expr << endl;
+            out << "F = " << expr << endl;
             
             // Store in AllExpressions map
             AllExpressions[i] = terms;
+            vector<uint32_t> solution = EPI;
+            solution.insert(solution.end(), solutionSets[i].begin(), solutionSets[i].end());
+            solutions.push_back(solution);
             
             // Generate Verilog for each minimized expression
+            if (!writeVerilog) continue;
             std::string moduleName = "minimized_logic_" + std::to_string(i);
             std::string verilogCode = generateVerilogModule(expr, moduleName);
             std::string filename = moduleName + ".v";
@@ -706,9 +930,9 @@ void Table::FinalExpression() {
             if (outFile.is_open()) {
                 outFile << verilogCode;
                 outFile.close();
-                std::cout << "Generated Verilog module written to " << filename << std::endl;
+                out << "Generated Verilog module written to " << filename << endl;
             } else {
-                std::cerr << "Failed to open " << filename << " for writing" << std::endl;
+                std::cerr << "Failed to open " << filename << " for writing" << endl;
             }
         }
     }
@@ -1,51 +1,128 @@
 #ifndef TABLE_H
 #define TABLE_H
 
+#include "Adjacency.h"
+#include "CancelToken.h"
 #include "Term.h"
+#include "ThreadPool.h"
 #include <vector>
 #include <string>
 #include <map>
 #include<set>
+#include <deque>
+#include <unordered_set>
+#include <iostream>
 
 using namespace std;
 
+// Which prime implicant generator generatePrimeImplicants runs
+// Zdd is handled by minimize() (see ZddCover.h); a Table given it merges tabularly
+enum class PIEngine { Auto, Tabular, Bitmap, Zdd };
+enum class CoverEngine { Auto, Petrick, BranchAndBound, Greedy };
+
+// One round of the tabular merge, stored column-wise: cube i is
+// (bits[i], dashes[i]) and covers cover[coverStart[i] .. +coverCount[i]].
+// Cubes are ordered by number of ones; group g occupies
+// groupStart[g] .. groupStart[g + 1]. clear() keeps every buffer's
+// capacity, so once a Table has seen its largest function the merge
+// allocates nothing.
+struct MergeLevel {
+    vector<uint32_t> bits, dashes;
+    vector<uint32_t> coverStart, coverCount;
+    vector<int> cover;
+    vector<uint32_t> groupStart;
+
+    size_t size() const { return bits.size(); }
+    size_t bytes() const { return size() * 4 * sizeof(uint32_t) + cover.size() * sizeof(int); }
+    void clear();
+    void add(uint32_t cubeBits, uint32_t cubeDashes);
+};
+
 class Table {
 
 public:
     vector<Term> terms;
-    vector<Term> primeImplicants;
-    vector<int> dont_cares;
-    vector <Term> EPI;
-    vector <Term> remainingPI;
-    map <int, vector<Term> > CoverageChart;
-    map <int, vector<Term> > reducedChart; //for uncovered minterms
+    vector<string> seedCubes;     // on/dc cubes from the input; see generatePrimeImplicants
+    vector<Term> primeImplicants; // stored once; everything below refers to a PI by its index here
+    vector<int> dont_cares;       // sorted
+    vector <uint32_t> EPI;
+    vector <uint32_t> remainingPI;
+    vector<uint8_t> piActive;     // cleared when a PI is dominated or moved into the cover
+    vector<uint8_t> piSelected;   // set once a PI is in EPI
+    vector<vector<int>> piMinterms; // minterms of each PI still in reducedChart (sorted)
+    map <int, vector<uint32_t> > CoverageChart;
+    map <int, vector<uint32_t> > reducedChart; //for uncovered minterms
     map <int, vector<string> > AllExpressions; //for all expressions
-vector<vector<int>> minimalResult;
-    vector<vector<int>> minimalSolutions;
+    vector<vector<int>> minimalSolutions; // indices into uniquePIs
 
-    vector<Term> uniquePIs;
+    vector<uint32_t> uniquePIs;   // Petrick variable -> PI index
 
-    vector<Term> selections;
+    vector<uint32_t> selections;
     set<int> C_m; //coveredminterms
-    map<string, set<int>> piToMinterms;
 
-    set<int> uncoveredMinterms;
-    Table(vector<Term> &minterms, vector<Term> &dontCares);
+    vector<vector<uint32_t>> solutions; // every final cover as PI indices, EPIs included
+
+    ostream &out;       // progress/debug log, cout for the command line
+    bool writeVerilog;  // emit minimized_logic*.v files into the working directory
+    PIEngine piEngine = PIEngine::Auto; // Auto picks the bitmap sweep for dense functions
+    CoverEngine coverEngine = CoverEngine::Auto; // Auto picks per block: Petrick, branch and bound, or greedy when too big
+    bool allSolutions = true;      // false keeps only the first minimal cover
+    ThreadPool *pool = nullptr;    // solves independent cover blocks concurrently when set
+    const CancelToken *cancel = nullptr; // polled by every stage; see CancelToken.h
+    bool exact = true;             // false once a stop request cut a stage short
+    // Bytes for the merge levels of prime implicant generation, 0 = no limit
+    // (see SpillMerge.h). The primes found, with their coveredMinterms, and
+    // the cover table that follows stay in memory outside the budget.
+    size_t memoryBudget = 0;
+    string spillDirectory;         // where spill files go, "" = $TMPDIR or /tmp
+
+    // generatePrimeImplicants scratch space, reused across rounds and reset()
+    MergeLevel levels[2];
+    vector<uint8_t> mergedFlags;
+    vector<uint32_t> matches;
+    vector<uint64_t> seenCubes; // open-addressing set of this round's new cubes
+    CubeIndex levelIndex;       // this round's cubes, when a group is large enough to look neighbours up
+
+    Table(vector<Term> &minterms, vector<Term> &dontCares, const vector<string> &cubes = {});
+    Table(ostream &log, bool writeVerilog = false);
+    // cubes are optional on/dc cubes whose points are already in the lists
+    void load(const vector<Term> &minterms, const vector<Term> &dontCares, const vector<string> &cubes = {});
+    void reset(); // forget the last function but keep the merge buffers for the next one
+    // With seedCubes, PIEngine::Auto and no memoryBudget, primes are grown
+    // from the cubes (plus the minterms outside them) by iterated consensus
+    // when ConsensusEngine::preferred says so; otherwise the points are
+    // merged as usual.
     void generatePrimeImplicants();
     void printPrimeImplicants();
     void EPIgeneration();
     void FinalExpression();
     //for dominance
     void processRemainingPI();
-    bool applyRowDominance();
-    bool applyColumnDominance();
     void applyDominanceRules();
-    void BestfitPI();
     //for Petrick Method
     void PetrickMethod();
     vector<vector<int>> expandToPetricksSOP(const vector<vector<int>>& pos);
+    static vector<vector<int>> fewestTerms(const vector<vector<int>>& sop);
+    vector<vector<vector<int>>> splitIntoBlocks(const vector<int>& piToIndex);
     int countLiterals(const Term& term);
 
+private:
+    bool insertSeen(uint64_t key, size_t &seenCount);
+    bool isDontCare(int m) const;
+    bool interrupted();
+    void dropInactivePIs();
+    // dominance worklist
+    void markRow(uint32_t p);
+    void markColumn(int m);
+    void removeRow(uint32_t p);
+    void removeColumn(int m);
+    void reduceRow(uint32_t p);
+    void reduceColumn(int m);
+    deque<uint32_t> dirtyRows;
+    deque<int> dirtyColumns;
+    vector<uint8_t> rowQueued;
+    unordered_set<int> columnQueued;
+
 
 
 };
@@ -29,6 +29,37 @@ string Term::combineTerms(const Term &a, const Term &b) {
     }
     return combined;
 }
+void Term::pack(const string &binary, uint32_t &bits, uint32_t &dashes) {
+    bits = 0;
+    dashes = 0;
+    for (char c : binary) {
+        bits = (bits << 1) | (c == '1');
+        dashes = (dashes << 1) | (c == '-');
+    }
+}
+
+string Term::unpack(uint32_t bits, uint32_t dashes, int numVariables) {
+    string binary(numVariables, '0');
+    for (int i = 0; i < numVariables; i++) {
+        uint32_t bit = 1u << (numVariables - 1 - i);
+        binary[i] = (dashes & bit) ? '-' : ((bits & bit) ? '1' : '0');
+    }
+    return binary;
+}
+
+Term Term::fromCube(uint32_t bits, uint32_t dashes, int numVariables) {
+    if (dashes == 0) return Term(int(bits), numVariables);
+    Term term(-1, numVariables);
+    term.binary = unpack(bits, dashes, numVariables);
+    term.coveredMinterms.clear();
+    uint32_t sub = 0;
+    do {
+        term.coveredMinterms.push_back(bits | sub);
+        sub = (sub - dashes) & dashes;
+    } while (sub != 0);
+    return term;
+}
+
 string Term::toExpression() const {
     string expr;
     char var = 'A';
@@ -46,3 +77,47 @@ string Term::toExpression() const {
     
     return expr;
 }
+
+string Term::toSum() const {
+    string expr;
+    char var = 'A';
+    for (size_t i = 0; i < binary.size(); i++, var++) {
+        if (binary[i] == '-') continue;
+        if (!expr.empty()) expr += " + ";
+        expr += var;
+        if (binary[i] == '1') expr += "'";
+    }
+    return "(" + expr + ")";
+}
+
+bool PrimeGrower::isImplicant(uint32_t bits, uint32_t dashes) {
+    if (dashes == 0) return inCare(bits);
+    uint64_t key = cubeKey(bits, dashes);
+    auto it = implicantMemo.find(key);
+    if (it != implicantMemo.end()) return it->second;
+    uint32_t v = dashes & -dashes;
+    bool result = isImplicant(bits, dashes & ~v) && isImplicant(bits | v, dashes & ~v);
+    implicantMemo[key] = result;
+    return result;
+}
+
+void PrimeGrower::growPrimes(uint32_t point, vector<Cube> &primes, const function<bool(uint32_t, uint32_t)> &keep) {
+    grow(point, 0, 0, primes, keep);
+}
+
+// Visits every implicant containing point once (dashes are only added above
+// from) and keeps those that cannot be raised any further
+void PrimeGrower::grow(uint32_t point, uint32_t dashes, int from, vector<Cube> &primes,
+                       const function<bool(uint32_t, uint32_t)> &keep) {
+    bool maximal = true;
+    for (int v = 0; v < numVariables; v++) {
+        uint32_t bit = 1u << v;
+        if (dashes & bit) continue;
+        if (!isImplicant(point & ~(dashes | bit), dashes | bit)) continue;
+        maximal = false;
+        if (v >= from) grow(point, dashes | bit, v + 1, primes, keep);
+    }
+    uint32_t bits = point & ~dashes;
+    if (!maximal || !found.insert(cubeKey(bits, dashes)).second) return;
+    if (!keep || keep(bits, dashes)) primes.push_back({ bits, dashes });
+}
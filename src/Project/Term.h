@@ -4,6 +4,11 @@
 #include <string>
 #include <algorithm>
 #include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 using namespace std;
 
 class Term {
@@ -17,7 +22,14 @@ public:
     static int countOnes(const string &binary);
     static bool canCombine(const Term &a, const Term &b);
     static string combineTerms(const Term &a, const Term &b);
+    // Packs binary into masks, variable A in the highest bit; dashes read as 0 in bits
+    static void pack(const string &binary, uint32_t &bits, uint32_t &dashes);
+    static string unpack(uint32_t bits, uint32_t dashes, int numVariables);
+    // The implicant for a packed cube; every point of it is a minterm or a don't-care
+    static Term fromCube(uint32_t bits, uint32_t dashes, int numVariables);
     string toExpression() const;
+    // The complement of this cube as a sum, e.g. "(A' + C)" for 1-0
+    string toSum() const;
     bool operator==(const Term& other) const {
         // For basic comparison, check if the binary representations match
         return binary == other.binary;}
@@ -27,4 +39,33 @@ public:
 
 };
 
+// Primes grown from single points of a function given by its care set (the
+// on-set plus don't-cares, one bit per point, as packed by Term::pack). A
+// cube is an implicant when both halves along any one of its dashes are
+// implicants, and a point is one when it is in the care set; the answers
+// are memoized per cube for the life of the grower.
+class PrimeGrower {
+public:
+    typedef pair<uint32_t, uint32_t> Cube; // (bits, dashes), dashes read as 0 in bits
+
+    // care is not copied and must outlive the grower
+    PrimeGrower(int numVariables, const vector<uint64_t> &care) : numVariables(numVariables), care(care) {}
+    static uint64_t cubeKey(uint32_t bits, uint32_t dashes) { return uint64_t(dashes) << 32 | bits; }
+    bool inCare(uint32_t x) const { return (care[x >> 6] >> (x & 63)) & 1; }
+    bool isImplicant(uint32_t bits, uint32_t dashes);
+    // Appends every prime containing point that no earlier call reached and
+    // that keep accepts (all of them when keep is empty), e.g. only the
+    // canonical ones under a symmetry
+    void growPrimes(uint32_t point, vector<Cube> &primes, const function<bool(uint32_t, uint32_t)> &keep = nullptr);
+
+private:
+    void grow(uint32_t point, uint32_t dashes, int from, vector<Cube> &primes,
+              const function<bool(uint32_t, uint32_t)> &keep);
+
+    int numVariables;
+    const vector<uint64_t> &care;
+    unordered_map<uint64_t, bool> implicantMemo;
+    unordered_set<uint64_t> found; // primes already reached
+};
+
 #endif
\ No newline at end of file
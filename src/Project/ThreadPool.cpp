@@ -0,0 +1,90 @@
+#include "ThreadPool.h"
+#include "Trace.h"
+
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; i++)
+        workers.emplace_back(&ThreadPool::worker, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto &t : workers) t.join();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> guard(lock);
+        tasks.push(move(task));
+    }
+    taskReady.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(lock);
+    allIdle.wait(guard, [this] { return tasks.empty() && active == 0; });
+}
+
+void ThreadPool::runAll(const vector<function<void()>> &jobs) {
+    struct Batch {
+        atomic<size_t> next{0};
+        size_t count = 0;
+        size_t done = 0;
+        mutex lock;
+        condition_variable finished;
+    };
+    auto batch = make_shared<Batch>();
+    batch->count = jobs.size();
+    auto drain = [batch, &jobs] {
+        size_t ran = 0;
+        for (size_t i; (i = batch->next++) < batch->count; ran++)
+            jobs[i]();
+        if (ran == 0) return;
+        lock_guard<mutex> guard(batch->lock);
+        batch->done += ran;
+        if (batch->done == batch->count) batch->finished.notify_all();
+    };
+
+    // Helpers that start after the caller has drained the batch return
+    // without touching jobs, so they may outlive this call
+    size_t helpers = min(jobs.size(), workers.size()) - (jobs.empty() ? 0 : 1);
+    for (size_t i = 0; i < helpers; i++)
+        submit(drain);
+    drain();
+    TraceSpan span("batch wait", jobs.size());
+    unique_lock<mutex> guard(batch->lock);
+    batch->finished.wait(guard, [&] { return batch->done == batch->count; });
+}
+
+void ThreadPool::worker() {
+    while (true) {
+        function<void()> task;
+        {
+            TraceSpan idle("queue wait"); // recorded once the lock is released
+            unique_lock<mutex> guard(lock);
+            taskReady.wait(guard, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return; // stopping and drained
+            task = move(tasks.front());
+            tasks.pop();
+            active++;
+        }
+        {
+            TraceSpan span("task");
+            task();
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            active--;
+            if (tasks.empty() && active == 0) allIdle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// ThreadPool.h
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads fed from one FIFO queue.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = thread::hardware_concurrency());
+    ~ThreadPool();
+    void submit(function<void()> task);
+    void wait(); // blocks until the queue is empty and every worker is idle
+    // Runs every job and returns once all have finished. The caller works on
+    // the jobs too, so it is safe to call from inside a pool task.
+    void runAll(const vector<function<void()>> &jobs);
+    size_t size() const { return workers.size(); }
+
+private:
+    void worker();
+
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex lock;
+    condition_variable taskReady;
+    condition_variable allIdle;
+    size_t active = 0;
+    bool stopping = false;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,126 @@
+#include "Trace.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+atomic<bool> Trace::enabled{false};
+
+struct TraceEvent {
+    const char *name;
+    int64_t begin, end, arg;
+};
+
+// Written by its thread only; read by write() once tracing has stopped
+struct TraceBuffer {
+    vector<TraceEvent> events; // ring, power-of-two size
+    atomic<uint64_t> written{0};
+    uint64_t session = 0;
+    uint32_t thread = 0;
+};
+
+static mutex registryLock;
+// Never shrinks: a thread keeps a pointer to its buffer for its lifetime
+static vector<unique_ptr<TraceBuffer>> buffers;
+static atomic<uint64_t> session{0};
+static size_t capacity = 1 << 16;
+static int64_t origin = 0;
+
+// The calling thread's buffer, reset on its first span of each session
+static TraceBuffer *localBuffer() {
+    thread_local TraceBuffer *buffer = nullptr;
+    uint64_t current = session.load(memory_order_acquire);
+    if (buffer && buffer->session == current) return buffer;
+    lock_guard<mutex> guard(registryLock);
+    if (!buffer) {
+        buffers.push_back(make_unique<TraceBuffer>());
+        buffer = buffers.back().get();
+        buffer->thread = uint32_t(buffers.size());
+    }
+    buffer->events.assign(capacity, TraceEvent{ nullptr, 0, 0, -1 });
+    buffer->written.store(0, memory_order_relaxed);
+    buffer->session = current;
+    return buffer;
+}
+
+static long processId() {
+#ifdef _WIN32
+    return long(_getpid());
+#else
+    return long(getpid());
+#endif
+}
+
+int64_t Trace::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::start(size_t eventsPerThread) {
+    lock_guard<mutex> guard(registryLock);
+    capacity = 1;
+    while (capacity < eventsPerThread) capacity *= 2;
+    origin = now();
+    session.fetch_add(1, memory_order_release);
+    enabled.store(true, memory_order_relaxed);
+}
+
+void Trace::stop() {
+    enabled.store(false, memory_order_relaxed);
+}
+
+void Trace::record(const char *name, int64_t begin, int64_t end, int64_t arg) {
+    TraceBuffer *buffer = localBuffer();
+    uint64_t i = buffer->written.load(memory_order_relaxed);
+    buffer->events[i & (buffer->events.size() - 1)] = { name, begin, end, arg };
+    buffer->written.store(i + 1, memory_order_release);
+}
+
+void Trace::write(ostream &out) {
+    lock_guard<mutex> guard(registryLock);
+    uint64_t current = session.load(memory_order_acquire);
+    long pid = processId();
+    // Trace-event timestamps are microseconds from the start of the trace
+    auto micros = [](int64_t ns) { return double(max<int64_t>(ns - origin, 0)) / 1000; };
+    out << fixed << setprecision(3) << "{\"traceEvents\":[";
+    const char *separator = "\n";
+    for (const auto &buffer : buffers) {
+        if (buffer->session != current) continue;
+        out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->thread
+            << ",\"args\":{\"name\":\"thread " << buffer->thread << "\"}}";
+        separator = ",\n";
+        uint64_t written = buffer->written.load(memory_order_acquire);
+        uint64_t size = buffer->events.size();
+        for (uint64_t i = written > size ? written - size : 0; i < written; i++) {
+            const TraceEvent &event = buffer->events[i & (size - 1)];
+            double begin = micros(event.begin);
+            out << separator << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->thread << ",\"ts\":" << begin << ",\"dur\":" << micros(event.end) - begin;
+            if (event.arg >= 0) out << ",\"args\":{\"value\":" << event.arg << "}";
+            out << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool Trace::write(const string &path, string &error) {
+    ofstream out(path);
+    if (!out) {
+        error = "cannot open " + path;
+        return false;
+    }
+    write(out);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+// Trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// Optional timeline of where a run spends its time, per thread, written in
+// the Chrome trace-event JSON format (load it in chrome://tracing or
+// ui.perfetto.dev). Spans go into a ring buffer owned by the thread that
+// records them: recording is two stores and no lock, and once a thread has
+// more than eventsPerThread spans its oldest ones are overwritten. While
+// tracing is off a span is a single relaxed load.
+//
+// Tracing is process-wide: start() before the runs to be traced, stop()
+// once they have finished, then write().
+class Trace {
+public:
+    static void start(size_t eventsPerThread = 1 << 16);
+    static void stop();
+    static bool active() { return enabled.load(memory_order_relaxed); }
+    // Every span recorded since start(), as one JSON object
+    static void write(ostream &out);
+    static bool write(const string &path, string &error);
+
+    // Nanoseconds on the steady clock
+    static int64_t now();
+    // name has to outlive the trace (a string literal); arg < 0 means none
+    static void record(const char *name, int64_t begin, int64_t end, int64_t arg);
+
+private:
+    static atomic<bool> enabled;
+};
+
+// Records the time from construction to destruction as a span named name
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name, int64_t arg = -1)
+        : name(name), arg(arg), begin(Trace::active() ? Trace::now() : -1) {}
+    ~TraceSpan() { end(); }
+    // Ends the span before the scope does; later calls do nothing
+    void end() {
+        if (begin >= 0 && Trace::active()) Trace::record(name, begin, Trace::now(), arg);
+        begin = -1;
+    }
+    void setArg(int64_t value) { arg = value; }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name;
+    int64_t arg;
+    int64_t begin;
+};
+
+#endif // TRACE_H
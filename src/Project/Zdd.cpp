@@ -0,0 +1,220 @@
+#include "Zdd.h"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+static const uint32_t Terminal = UINT32_MAX; // var of Empty and Base, below every real variable
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+Zdd::Zdd(int cacheBits) : unique(1024, 0), cache(size_t(1) << cacheBits, CacheEntry{ 0, 0, 0, 0 }) {
+    nodes.push_back({ Terminal, Empty, Empty });
+    nodes.push_back({ Terminal, Base, Base });
+}
+
+size_t Zdd::slotOf(uint32_t var, Node lo, Node hi) const {
+    return mix(uint64_t(var) * 0x9e3779b97f4a7c15ULL ^ (uint64_t(lo) << 32 | hi)) & (unique.size() - 1);
+}
+
+void Zdd::grow() {
+    vector<Node> old(unique.size() * 2, 0);
+    old.swap(unique);
+    for (Node n : old) {
+        if (n == 0) continue;
+        size_t slot = slotOf(nodes[n].var, nodes[n].lo, nodes[n].hi);
+        while (unique[slot] != 0) slot = (slot + 1) & (unique.size() - 1);
+        unique[slot] = n;
+    }
+}
+
+Zdd::Node Zdd::make(uint32_t var, Node lo, Node hi) {
+    if (hi == Empty) return lo;
+    size_t slot = slotOf(var, lo, hi);
+    for (; unique[slot] != 0; slot = (slot + 1) & (unique.size() - 1)) {
+        const NodeData &node = nodes[unique[slot]];
+        if (node.var == var && node.lo == lo && node.hi == hi) return unique[slot];
+    }
+    Node n = Node(nodes.size());
+    nodes.push_back({ var, lo, hi });
+    unique[slot] = n;
+    if (nodes.size() * 2 > unique.size()) grow();
+    return n;
+}
+
+bool Zdd::cached(Op op, Node a, Node b, Node &result) const {
+    const CacheEntry &entry = cache[mix(uint64_t(op) << 58 ^ uint64_t(a) << 29 ^ b) & (cache.size() - 1)];
+    if (entry.op != op || entry.a != a || entry.b != b) return false;
+    result = entry.result;
+    return true;
+}
+
+Zdd::Node Zdd::store(Op op, Node a, Node b, Node result) {
+    computed++;
+    cache[mix(uint64_t(op) << 58 ^ uint64_t(a) << 29 ^ b) & (cache.size() - 1)] = { op, a, b, result };
+    return result;
+}
+
+Zdd::Node Zdd::unite(Node a, Node b) {
+    if (a == Empty) return b;
+    if (b == Empty || a == b) return a;
+    if (a > b) swap(a, b);
+    Node result;
+    if (cached(Unite, a, b, result)) return result;
+    uint32_t va = var(a), vb = var(b);
+    if (va < vb) result = make(va, unite(lo(a), b), hi(a));
+    else if (va > vb) result = make(vb, unite(a, lo(b)), hi(b));
+    else result = make(va, unite(lo(a), lo(b)), unite(hi(a), hi(b)));
+    return store(Unite, a, b, result);
+}
+
+Zdd::Node Zdd::intersect(Node a, Node b) {
+    if (a == Empty || b == Empty) return Empty;
+    if (a == b) return a;
+    if (a > b) swap(a, b);
+    Node result;
+    if (cached(Intersect, a, b, result)) return result;
+    uint32_t va = var(a), vb = var(b);
+    if (va < vb) result = intersect(lo(a), b);
+    else if (va > vb) result = intersect(a, lo(b));
+    else result = make(va, intersect(lo(a), lo(b)), intersect(hi(a), hi(b)));
+    return store(Intersect, a, b, result);
+}
+
+Zdd::Node Zdd::difference(Node a, Node b) {
+    if (a == Empty || a == b) return Empty;
+    if (b == Empty) return a;
+    Node result;
+    if (cached(Difference, a, b, result)) return result;
+    uint32_t va = var(a), vb = var(b);
+    if (va < vb) result = make(va, difference(lo(a), b), hi(a));
+    else if (va > vb) result = difference(a, lo(b));
+    else result = make(va, difference(lo(a), lo(b)), difference(hi(a), hi(b)));
+    return store(Difference, a, b, result);
+}
+
+Zdd::Node Zdd::subset0(Node a, uint32_t v) {
+    if (var(a) > v) return a; // terminals included
+    Node result;
+    if (cached(Subset0, a, v, result)) return result;
+    if (var(a) == v) result = lo(a);
+    else result = make(var(a), subset0(lo(a), v), subset0(hi(a), v));
+    return store(Subset0, a, v, result);
+}
+
+Zdd::Node Zdd::subset1(Node a, uint32_t v) {
+    if (var(a) > v) return Empty;
+    Node result;
+    if (cached(Subset1, a, v, result)) return result;
+    if (var(a) == v) result = hi(a);
+    else result = make(var(a), subset1(lo(a), v), subset1(hi(a), v));
+    return store(Subset1, a, v, result);
+}
+
+Zdd::Node Zdd::join(Node a, Node b) {
+    if (a == Empty || b == Empty) return Empty;
+    if (a == Base) return b;
+    if (b == Base) return a;
+    if (a > b) swap(a, b);
+    Node result;
+    if (cached(Join, a, b, result)) return result;
+    uint32_t v = min(var(a), var(b));
+    Node a0 = var(a) == v ? lo(a) : a, a1 = var(a) == v ? hi(a) : Empty;
+    Node b0 = var(b) == v ? lo(b) : b, b1 = var(b) == v ? hi(b) : Empty;
+    Node withVar = unite(join(a1, b1), unite(join(a1, b0), join(a0, b1)));
+    result = make(v, join(a0, b0), withVar);
+    return store(Join, a, b, result);
+}
+
+// A set with v contains q when q has v and the rest contains q without v,
+// or q lacks v and the rest contains q
+Zdd::Node Zdd::nonSuperset(Node a, Node b) {
+    if (a == Empty || b == Empty) return a;
+    if (b == Base || a == b) return Empty; // every set contains the empty set
+    if (a == Base) {
+        while (b > Base) b = lo(b); // does b hold the empty set?
+        return b == Base ? Empty : Base;
+    }
+    Node result;
+    if (cached(NonSuperset, a, b, result)) return result;
+    uint32_t va = var(a), vb = var(b);
+    if (va > vb) {
+        result = nonSuperset(a, lo(b));
+    } else {
+        Node b0 = va == vb ? lo(b) : b, b1 = va == vb ? hi(b) : Empty;
+        Node withVar = intersect(nonSuperset(hi(a), b0), nonSuperset(hi(a), b1));
+        result = make(va, nonSuperset(lo(a), b0), withVar);
+    }
+    return store(NonSuperset, a, b, result);
+}
+
+Zdd::Node Zdd::minimal(Node a) {
+    if (a <= Base) return a;
+    Node result;
+    if (cached(Minimal, a, 0, result)) return result;
+    Node without = minimal(lo(a));
+    result = make(var(a), without, nonSuperset(minimal(hi(a)), without));
+    return store(Minimal, a, 0, result);
+}
+
+size_t Zdd::minSize(Node a) {
+    if (a == Empty) return SIZE_MAX;
+    if (a == Base) return 0;
+    auto it = minSizes.find(a);
+    if (it != minSizes.end()) return it->second;
+    size_t without = minSize(lo(a)), with = minSize(hi(a));
+    size_t result = min(without, with == SIZE_MAX ? SIZE_MAX : with + 1);
+    minSizes[a] = result;
+    return result;
+}
+
+Zdd::Node Zdd::minimum(Node a) {
+    if (a <= Base) return a;
+    Node result;
+    if (cached(Minimum, a, 0, result)) return result;
+    size_t best = minSize(a), without = minSize(lo(a)), with = minSize(hi(a));
+    result = make(var(a), without == best ? minimum(lo(a)) : Empty,
+                  with != SIZE_MAX && with + 1 == best ? minimum(hi(a)) : Empty);
+    return store(Minimum, a, 0, result);
+}
+
+Zdd::Node Zdd::atMost(Node a, uint32_t k) {
+    if (a <= Base) return a;
+    if (k == 0) {
+        while (a > Base) a = lo(a);
+        return a;
+    }
+    Node result;
+    if (cached(AtMost, a, k, result)) return result;
+    result = make(var(a), atMost(lo(a), k), atMost(hi(a), k - 1));
+    return store(AtMost, a, k, result);
+}
+
+double Zdd::count(Node a) {
+    if (a <= Base) return a;
+    auto it = counts.find(a);
+    if (it != counts.end()) return it->second;
+    double result = count(lo(a)) + count(hi(a));
+    counts[a] = result;
+    return result;
+}
+
+void Zdd::enumerate(Node a, const function<bool(const vector<uint32_t> &)> &visit) {
+    vector<uint32_t> path;
+    walk(a, path, visit);
+}
+
+bool Zdd::walk(Node a, vector<uint32_t> &path, const function<bool(const vector<uint32_t> &)> &visit) {
+    if (a == Empty) return true;
+    if (a == Base) return visit(path);
+    if (!walk(lo(a), path, visit)) return false;
+    path.push_back(var(a));
+    bool more = walk(hi(a), path, visit);
+    path.pop_back();
+    return more;
+}
@@ -0,0 +1,82 @@
+// Zdd.h
+#ifndef ZDD_H
+#define ZDD_H
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Zero-suppressed decision diagrams: families of sets of small integers,
+// shared in one node store. A node (var, lo, hi) is the family lo plus
+// {var} joined to every set of hi; a node whose hi is Empty is never made,
+// so sets only mention the variables they contain, which keeps sparse
+// families (cubes as sets of literals, covers as sets of primes) small.
+// Variables nearer the root are smaller. Nodes are hash-consed through the
+// unique table, so equal families are the same node and compare with ==,
+// and every operation goes through a direct-mapped compute cache. Nodes
+// are never freed: a manager serves one minimization.
+class Zdd {
+public:
+    typedef uint32_t Node;
+    static const Node Empty = 0; // no set at all
+    static const Node Base = 1;  // only the empty set
+
+    explicit Zdd(int cacheBits = 18);
+
+    Node make(uint32_t var, Node lo, Node hi);
+    Node single(uint32_t var) { return make(var, Empty, Base); } // {{var}}
+
+    Node unite(Node a, Node b);
+    Node intersect(Node a, Node b);
+    Node difference(Node a, Node b);
+    Node subset0(Node a, uint32_t var); // sets without var
+    Node subset1(Node a, uint32_t var); // sets with var, var taken out
+    // {x | y : x in a, y in b}, the product of two sums in Petrick's method
+    Node join(Node a, Node b);
+    // Sets of a that contain no set of b
+    Node nonSuperset(Node a, Node b);
+    // Sets that contain no other set of the family (absorption)
+    Node minimal(Node a);
+    // The sets of least size
+    Node minimum(Node a);
+    // The sets of at most k elements
+    Node atMost(Node a, uint32_t k);
+
+    double count(Node a);
+    size_t minSize(Node a); // SIZE_MAX for Empty
+    // Calls visit with each set, variables ascending; stops when it returns false
+    void enumerate(Node a, const function<bool(const vector<uint32_t> &)> &visit);
+
+    uint32_t var(Node a) const { return nodes[a].var; }
+    Node lo(Node a) const { return nodes[a].lo; }
+    Node hi(Node a) const { return nodes[a].hi; }
+    size_t size() const { return nodes.size(); }
+    size_t steps() const { return computed; } // results computed so far, a measure of work
+
+private:
+    enum Op : uint32_t { Unite = 1, Intersect, Difference, Subset0, Subset1, Join, NonSuperset, Minimal, Minimum, AtMost };
+    struct NodeData {
+        uint32_t var, lo, hi;
+    };
+    struct CacheEntry {
+        uint32_t op, a, b, result;
+    };
+
+    size_t slotOf(uint32_t var, Node lo, Node hi) const;
+    void grow();
+    bool cached(Op op, Node a, Node b, Node &result) const;
+    Node store(Op op, Node a, Node b, Node result);
+    bool walk(Node a, vector<uint32_t> &path, const function<bool(const vector<uint32_t> &)> &visit);
+
+    vector<NodeData> nodes;
+    vector<Node> unique; // open addressing, 0 = free slot (Empty is never stored)
+    vector<CacheEntry> cache;
+    unordered_map<Node, double> counts;
+    unordered_map<Node, size_t> minSizes;
+    size_t computed = 0;
+};
+
+#endif // ZDD_H
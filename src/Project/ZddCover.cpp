@@ -0,0 +1,409 @@
+#include "ZddCover.h"
+#include "CoverSearch.h"
+#include "GreedyCover.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unordered_set>
+
+using namespace std;
+
+ZddCover::ZddCover(int numVariables, const vector<int> &onSet, const vector<int> &dcSet)
+    : numVariables(numVariables), containingMemo(numVariables), rowsSeen(numVariables) {
+    vector<int> points = onSet;
+    sort(points.begin(), points.end());
+    points.erase(unique(points.begin(), points.end()), points.end());
+    on = buildPoints(points, 0, points.size(), 0);
+    points.insert(points.end(), dcSet.begin(), dcSet.end());
+    sort(points.begin(), points.end());
+    points.erase(unique(points.begin(), points.end()), points.end());
+    care = buildPoints(points, 0, points.size(), 0);
+}
+
+// Sorted points split on variable v (the highest bit left) into the ones
+// with v = 0 and then the ones with v = 1
+Zdd::Node ZddCover::buildPoints(const vector<int> &points, size_t begin, size_t end, int v) {
+    if (begin == end) return Zdd::Empty;
+    if (v == numVariables) return Zdd::Base;
+    int bit = 1 << (numVariables - 1 - v);
+    size_t middle = partition_point(points.begin() + begin, points.begin() + end,
+                                    [&](int x) { return !(x & bit); }) - points.begin();
+    Zdd::Node zeros = buildPoints(points, begin, middle, v + 1);
+    Zdd::Node ones = buildPoints(points, middle, end, v + 1);
+    return zdd.make(v, zeros, ones);
+}
+
+Zdd::Node ZddCover::primesOf(Zdd::Node f, int v) {
+    if (f == Zdd::Empty) return Zdd::Empty;
+    // Every point of the remaining variables: the empty cube
+    if (zdd.count(f) == ldexp(1.0, numVariables - v)) return Zdd::Base;
+    uint64_t key = uint64_t(f) << 8 | v;
+    auto it = primeMemo.find(key);
+    if (it != primeMemo.end()) return it->second;
+
+    Zdd::Node f0 = zdd.subset0(f, v), f1 = zdd.subset1(f, v);
+    Zdd::Node both = primesOf(zdd.intersect(f0, f1), v + 1);
+    Zdd::Node without = zdd.difference(primesOf(f0, v + 1), both);
+    Zdd::Node with = zdd.difference(primesOf(f1, v + 1), both);
+    Zdd::Node result = zdd.make(2 * v, zdd.make(2 * v + 1, both, without), with);
+    primeMemo[key] = result;
+    return result;
+}
+
+Zdd::Node ZddCover::primes() {
+    if (!primesDone) {
+        primeFamily = primesOf(care, 0);
+        primesDone = true;
+        primeMemo.clear();
+    }
+    return primeFamily;
+}
+
+// Points (over variables v and up) that lie in at least one of the cubes
+Zdd::Node ZddCover::pointsOf(Zdd::Node cubes, int v) {
+    if (cubes == Zdd::Empty) return Zdd::Empty;
+    if (v == numVariables) return Zdd::Base;
+    uint64_t key = uint64_t(cubes) << 8 | v;
+    auto it = pointsMemo.find(key);
+    if (it != pointsMemo.end()) return it->second;
+    Zdd::Node with = zdd.subset1(cubes, 2 * v), rest = zdd.subset0(cubes, 2 * v);
+    Zdd::Node without = zdd.subset1(rest, 2 * v + 1), free = zdd.subset0(rest, 2 * v + 1);
+    Zdd::Node anywhere = pointsOf(free, v + 1);
+    Zdd::Node result = zdd.make(v, zdd.unite(pointsOf(without, v + 1), anywhere),
+                                zdd.unite(pointsOf(with, v + 1), anywhere));
+    pointsMemo[key] = result;
+    return result;
+}
+
+// Points that lie in at least two of the cubes: twice on one side of v, or
+// once among the cubes fixing v and once among the ones that leave it free
+Zdd::Node ZddCover::sharedPoints(Zdd::Node cubes, int v) {
+    if (cubes <= Zdd::Base || v == numVariables) return Zdd::Empty;
+    uint64_t key = uint64_t(cubes) << 8 | v;
+    auto it = sharedMemo.find(key);
+    if (it != sharedMemo.end()) return it->second;
+    Zdd::Node with = zdd.subset1(cubes, 2 * v), rest = zdd.subset0(cubes, 2 * v);
+    Zdd::Node without = zdd.subset1(rest, 2 * v + 1), free = zdd.subset0(rest, 2 * v + 1);
+    Zdd::Node anywhere = pointsOf(free, v + 1), twice = sharedPoints(free, v + 1);
+    Zdd::Node zeros = zdd.unite(zdd.unite(sharedPoints(without, v + 1), twice),
+                                zdd.intersect(pointsOf(without, v + 1), anywhere));
+    Zdd::Node ones = zdd.unite(zdd.unite(sharedPoints(with, v + 1), twice),
+                               zdd.intersect(pointsOf(with, v + 1), anywhere));
+    Zdd::Node result = zdd.make(v, zeros, ones);
+    sharedMemo[key] = result;
+    return result;
+}
+
+// The cubes that contain at least one of the points
+Zdd::Node ZddCover::containing(Zdd::Node cubes, Zdd::Node points, int v) {
+    if (cubes == Zdd::Empty || points == Zdd::Empty) return Zdd::Empty;
+    if (v == numVariables) return cubes;
+    uint64_t key = uint64_t(cubes) << 32 | points;
+    auto it = containingMemo[v].find(key);
+    if (it != containingMemo[v].end()) return it->second;
+    Zdd::Node zeros = zdd.subset0(points, v), ones = zdd.subset1(points, v);
+    Zdd::Node with = zdd.subset1(cubes, 2 * v), rest = zdd.subset0(cubes, 2 * v);
+    Zdd::Node without = zdd.subset1(rest, 2 * v + 1), free = zdd.subset0(rest, 2 * v + 1);
+    Zdd::Node result = zdd.make(2 * v, zdd.make(2 * v + 1, containing(free, zdd.unite(zeros, ones), v + 1),
+                                                containing(without, zeros, v + 1)),
+                                containing(with, ones, v + 1));
+    containingMemo[v][key] = result;
+    return result;
+}
+
+// The rows of the cover table over the points, in the order of the points:
+// each point keeps the cubes with no literal it contradicts, and points
+// that end up with the same cubes share one family node
+void ZddCover::collectRows(Zdd::Node cubes, Zdd::Node points, int v, vector<Zdd::Node> &rows) {
+    if (cubes == Zdd::Empty || points == Zdd::Empty) return;
+    if (v == numVariables) {
+        rows.push_back(cubes);
+        return;
+    }
+    if (!rowsSeen[v].insert(uint64_t(cubes) << 32 | points).second) return;
+    collectRows(zdd.subset0(cubes, 2 * v), zdd.subset0(points, v), v + 1, rows);
+    collectRows(zdd.subset0(cubes, 2 * v + 1), zdd.subset1(points, v), v + 1, rows);
+}
+
+// The numbers of a row's primes, ascending, a prime's number being its rank
+// in family (every lo branch passed over holds count(lo) earlier sets). row
+// is a subfamily of family.
+void ZddCover::ranksOf(Zdd::Node family, Zdd::Node row, uint32_t offset, vector<uint32_t> &ids) {
+    if (row == Zdd::Empty) return;
+    if (family == Zdd::Base) {
+        ids.push_back(offset);
+        return;
+    }
+    Zdd::Node lo = zdd.lo(family);
+    if (zdd.var(row) != zdd.var(family)) return ranksOf(lo, row, offset, ids);
+    ranksOf(lo, zdd.lo(row), offset, ids);
+    ranksOf(zdd.hi(family), zdd.hi(row), offset + uint32_t(zdd.count(lo)), ids);
+}
+
+string ZddCover::unrank(Zdd::Node family, uint32_t id) {
+    string cube(numVariables, '-');
+    double position = id;
+    Zdd::Node node = family;
+    while (node > Zdd::Base) {
+        double before = zdd.count(zdd.lo(node));
+        if (position < before) {
+            node = zdd.lo(node);
+        } else {
+            position -= before;
+            uint32_t literal = zdd.var(node);
+            cube[literal / 2] = literal % 2 ? '0' : '1';
+            node = zdd.hi(node);
+        }
+    }
+    return cube;
+}
+
+// Cyclic core for the search, as the Table builds it: a row left with a
+// single prime settles it, a row holding every prime of another is met
+// whenever that one is, and a prime covering a subset of another's rows
+// is dropped. Dropping primes can lose covers that only swap one prime for
+// an equivalent one, which the diagram would have kept.
+static vector<vector<int>> cyclicCore(vector<vector<int>> rows, vector<int> &essential) {
+    for (bool changed = true; changed && !rows.empty();) {
+        changed = false;
+        unordered_map<int, vector<int>> covered; // prime -> rows, ascending
+        for (size_t r = 0; r < rows.size(); r++)
+            for (int c : rows[r]) covered[c].push_back(int(r));
+        // A row inside another starts with one of its primes; of two equal
+        // rows the later one goes
+        vector<uint8_t> met(rows.size(), 0);
+        for (size_t a = 0; a < rows.size(); a++)
+            for (size_t i = 0; i < rows[a].size() && !met[a]; i++)
+                for (int b : covered[rows[a][i]]) {
+                    const vector<int> &inner = rows[b];
+                    if (size_t(b) == a || met[b] || inner[0] != rows[a][i] || inner.size() > rows[a].size()) continue;
+                    if (inner.size() == rows[a].size() && size_t(b) > a) continue;
+                    if (includes(rows[a].begin(), rows[a].end(), inner.begin(), inner.end())) {
+                        met[a] = 1;
+                        changed = true;
+                        break;
+                    }
+                }
+        if (changed) {
+            vector<vector<int>> left;
+            for (size_t r = 0; r < rows.size(); r++)
+                if (!met[r]) left.push_back(move(rows[r]));
+            rows.swap(left);
+            covered.clear();
+            for (size_t r = 0; r < rows.size(); r++)
+                for (int c : rows[r]) covered[c].push_back(int(r));
+        }
+        unordered_set<int> dropped;
+        for (const auto &[a, rowsOfA] : covered)
+            // Only a prime sharing a's first row can cover all of a's rows
+            for (int b : rows[rowsOfA[0]]) {
+                const vector<int> &rowsOfB = covered[b];
+                if (b == a || dropped.count(b) || rowsOfB.size() < rowsOfA.size()) continue;
+                // Of two primes with the same rows the later one goes
+                if (rowsOfB.size() == rowsOfA.size() && b > a) continue;
+                if (includes(rowsOfB.begin(), rowsOfB.end(), rowsOfA.begin(), rowsOfA.end())) {
+                    dropped.insert(a);
+                    changed = true;
+                    break;
+                }
+            }
+        for (auto &row : rows)
+            row.erase(remove_if(row.begin(), row.end(), [&](int c) { return dropped.count(c) > 0; }), row.end());
+
+        vector<int> taken;
+        for (const auto &row : rows)
+            if (row.size() == 1) taken.push_back(row[0]);
+        sort(taken.begin(), taken.end());
+        taken.erase(unique(taken.begin(), taken.end()), taken.end());
+        if (taken.empty()) continue;
+        essential.insert(essential.end(), taken.begin(), taken.end());
+        vector<vector<int>> left;
+        for (auto &row : rows)
+            if (none_of(row.begin(), row.end(), [&](int c) { return binary_search(taken.begin(), taken.end(), c); }))
+                left.push_back(move(row));
+        rows.swap(left);
+        changed = true;
+    }
+    return rows;
+}
+
+// The rows grouped into blocks that share no prime, by union-find over the
+// primes; each block is a cover problem of its own
+static vector<vector<vector<int>>> splitIntoBlocks(vector<vector<int>> rows) {
+    int columns = 0;
+    for (const auto &row : rows) columns = max(columns, *max_element(row.begin(), row.end()) + 1);
+    vector<int> parent(columns);
+    for (int c = 0; c < columns; c++) parent[c] = c;
+    auto root = [&](int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+    for (const auto &row : rows)
+        for (int c : row) parent[root(c)] = root(row[0]);
+    vector<vector<vector<int>>> blocks;
+    unordered_map<int, size_t> blockOf;
+    for (auto &row : rows) {
+        auto it = blockOf.emplace(root(row[0]), blocks.size()).first;
+        if (it->second == blocks.size()) blocks.emplace_back();
+        blocks[it->second].push_back(move(row));
+    }
+    return blocks;
+}
+
+// A cube of literals as a string over {0,1,-}, variable A first
+static string cubeString(const vector<uint32_t> &literals, int numVariables) {
+    string cube(numVariables, '-');
+    for (uint32_t literal : literals) cube[literal / 2] = literal % 2 ? '0' : '1';
+    return cube;
+}
+
+vector<vector<string>> ZddCover::covers(size_t maxSolutions, ThreadPool *pool, const CancelToken *cancelToken,
+                                       bool &exact) {
+    Zdd::Node all = primes();
+
+    // Essential primes are the ones holding an on-set point no other prime
+    // holds (every point is in some prime); the rest of the table is the
+    // on-set they leave open and the primes that meet it
+    Zdd::Node alone = zdd.difference(on, sharedPoints(all, 0));
+    Zdd::Node essential = containing(all, alone, 0);
+    Zdd::Node open = zdd.difference(on, pointsOf(essential, 0));
+    Zdd::Node candidates = containing(zdd.difference(all, essential), open, 0);
+
+    // The rows as one family, each distinct row the set of its primes'
+    // numbers. A row holding every prime of another adds nothing to the
+    // product, and the absorption below drops what it would have added.
+    vector<Zdd::Node> found, distinct;
+    collectRows(candidates, open, 0, found);
+    unordered_set<Zdd::Node> seen;
+    for (Zdd::Node row : found)
+        if (seen.insert(row).second) distinct.push_back(row);
+    vector<Zdd::Node> sets;
+    for (Zdd::Node row : distinct) {
+        vector<uint32_t> ids;
+        ranksOf(candidates, row, 0, ids);
+        Zdd::Node set = Zdd::Base;
+        for (size_t i = ids.size(); i-- > 0;) set = zdd.make(ids[i], Zdd::Empty, set);
+        sets.push_back(set);
+    }
+    while (sets.size() > 1) {
+        for (size_t i = 0; i < sets.size(); i += 2)
+            sets[i / 2] = i + 1 < sets.size() ? zdd.unite(sets[i], sets[i + 1]) : sets[i];
+        sets.resize((sets.size() + 1) / 2);
+    }
+    Zdd::Node rows = sets.empty() ? Zdd::Empty : sets[0];
+    pointsMemo.clear();
+    sharedMemo.clear();
+    for (auto &memo : containingMemo) memo.clear();
+    for (auto &seen : rowsSeen) seen.clear();
+
+    // Petrick's product of sums on the diagram, the rows taken from the
+    // family shortest first, with absorption after every factor. Taking the
+    // first prime of every row still open is a cover, so partial products
+    // larger than it are cut as they appear. Past stepBudget steps the rows
+    // are written out and left to the search on the cyclic core (or
+    // the greedy cover when that is too large).
+    uint32_t bound = 0;
+    for (Zdd::Node left = rows; left > Zdd::Base; left = zdd.lo(left)) bound++;
+    size_t limit = zdd.steps() + stepBudget;
+    Zdd::Node product = Zdd::Base;
+    bool expanded = true;
+    for (uint32_t size = 1; expanded && zdd.atMost(rows, size - 1) != rows; size++) {
+        Zdd::Node ofSize = zdd.difference(zdd.atMost(rows, size), zdd.atMost(rows, size - 1));
+        zdd.enumerate(ofSize, [&](const vector<uint32_t> &row) {
+            if ((cancelToken && cancelToken->stopRequested()) || zdd.steps() > limit) {
+                expanded = false;
+                return false;
+            }
+            Zdd::Node sum = Zdd::Empty;
+            for (size_t i = row.size(); i-- > 0;) sum = zdd.make(row[i], sum, Zdd::Base);
+            product = zdd.minimal(zdd.atMost(zdd.join(product, sum), bound));
+            return true;
+        });
+    }
+
+    vector<vector<uint32_t>> chosen;
+    if (expanded) {
+        zdd.enumerate(zdd.minimum(product), [&](const vector<uint32_t> &ids) {
+            chosen.push_back(ids);
+            if (cancelToken && cancelToken->stopRequested()) {
+                exact = false; // minimum, but not every minimum cover is listed
+                return false;
+            }
+            return chosen.size() != maxSolutions;
+        });
+    } else {
+        // Columns are numbered in the order the on-set first meets them,
+        // as the Table numbers its primes, which keeps the greedy cover's
+        // ties between neighbouring primes
+        vector<vector<int>> table;
+        vector<int> column(size_t(zdd.count(candidates)), -1);
+        vector<uint32_t> idOf;
+        for (Zdd::Node row : distinct) {
+            vector<uint32_t> ids;
+            ranksOf(candidates, row, 0, ids);
+            table.emplace_back();
+            for (uint32_t id : ids) {
+                if (column[id] < 0) {
+                    column[id] = int(idOf.size());
+                    idOf.push_back(id);
+                }
+                table.back().push_back(column[id]);
+            }
+            sort(table.back().begin(), table.back().end());
+        }
+        vector<int> settled;
+        vector<vector<vector<int>>> blocks = splitIntoBlocks(cyclicCore(table, settled));
+        vector<vector<vector<int>>> solved(blocks.size());
+        atomic<bool> approximate(false);
+        auto solveBlock = [&](size_t b) {
+            if (GreedyCover::preferred(blocks[b])) {
+                solved[b] = { GreedyCover::solve(blocks[b]) };
+                approximate = true;
+                return;
+            }
+            CoverSearch solver(blocks[b]);
+            solver.allCovers = maxSolutions != 1;
+            solved[b] = solver.solve(pool, GreedyCover::solve(blocks[b]), cancelToken);
+            if (!solver.complete()) approximate = true;
+        };
+        if (pool && blocks.size() > 1) {
+            vector<function<void()>> jobs;
+            for (size_t b = 0; b < blocks.size(); b++) jobs.push_back([&, b] { solveBlock(b); });
+            pool->runAll(jobs);
+        } else {
+            for (size_t b = 0; b < blocks.size(); b++) solveBlock(b);
+        }
+        if (approximate) exact = false;
+        // Every combination of the blocks' covers is a cover of the table
+        vector<vector<int>> combined = { settled };
+        for (const auto &coversOfBlock : solved) {
+            vector<vector<int>> next;
+            for (const auto &partial : combined)
+                for (const auto &columns : coversOfBlock) {
+                    if (next.size() == maxSolutions) break;
+                    next.push_back(partial);
+                    next.back().insert(next.back().end(), columns.begin(), columns.end());
+                }
+            combined.swap(next);
+        }
+        for (const auto &columns : combined) {
+            chosen.emplace_back();
+            for (int c : columns) chosen.back().push_back(idOf[c]);
+        }
+    }
+
+    vector<string> essentialCubes;
+    zdd.enumerate(essential, [&](const vector<uint32_t> &literals) {
+        essentialCubes.push_back(cubeString(literals, numVariables));
+        return true;
+    });
+    vector<vector<string>> result;
+    for (auto &ids : chosen) {
+        sort(ids.begin(), ids.end());
+        vector<string> cover = essentialCubes;
+        for (uint32_t id : ids) cover.push_back(unrank(candidates, id));
+        sort(cover.begin(), cover.end());
+        result.push_back(cover);
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+// ZddCover.h
+#ifndef ZDDCOVER_H
+#define ZDDCOVER_H
+
+#include "CancelToken.h"
+#include "ThreadPool.h"
+#include "Zdd.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// Implicit minimization for functions whose primes or Petrick products are
+// too many to list. The on-set plus don't-cares is a family of points (the
+// set of variables that are 1), the primes a family of cubes (literal 2v is
+// variable v uncomplemented, 2v + 1 complemented, 0 is A) computed on the
+// diagram by the cofactor recursion
+//   P(f) = P(f0.f1) + x'(P(f0) - P(f0.f1)) + x(P(f1) - P(f0.f1)),
+// and the covers a family of sets of prime numbers, a prime's number being
+// its rank in the prime family. The cover table stays on the diagram too:
+// essential primes come from the points only one prime holds, the open
+// on-set and the primes meeting it are families again, and the rows are
+// collected once per distinct set of primes into a family of Petrick sums.
+// The product of those sums is expanded on the diagram, absorbed and cut at
+// the size of a known cover; a product that outgrows stepBudget writes the
+// rows out for CoverSearch (or GreedyCover) instead. Only the chosen covers
+// are turned back into cubes.
+class ZddCover {
+public:
+    ZddCover(int numVariables, const vector<int> &onSet, const vector<int> &dcSet);
+
+    // Built on first use; the recursion is memoized on (point family, level)
+    Zdd::Node primes();
+    double primeCount() { return zdd.count(primes()); }
+    // Minimum covers, at most maxSolutions of them (0 = all). exact is
+    // cleared when a stop request cut the search short.
+    vector<vector<string>> covers(size_t maxSolutions, ThreadPool *pool, const CancelToken *cancel, bool &exact);
+    size_t stepBudget = 1 << 18; // Zdd::steps the product may take before the explicit search
+
+    Zdd zdd;
+
+private:
+    Zdd::Node buildPoints(const vector<int> &points, size_t begin, size_t end, int v);
+    Zdd::Node primesOf(Zdd::Node f, int v);
+    Zdd::Node pointsOf(Zdd::Node cubes, int v);
+    Zdd::Node sharedPoints(Zdd::Node cubes, int v);
+    Zdd::Node containing(Zdd::Node cubes, Zdd::Node points, int v);
+    void collectRows(Zdd::Node cubes, Zdd::Node points, int v, vector<Zdd::Node> &rows);
+    void ranksOf(Zdd::Node family, Zdd::Node row, uint32_t offset, vector<uint32_t> &ids);
+    string unrank(Zdd::Node family, uint32_t id);
+
+    int numVariables;
+    Zdd::Node on, care;
+    Zdd::Node primeFamily = Zdd::Empty;
+    bool primesDone = false;
+    unordered_map<uint64_t, Zdd::Node> primeMemo; // (point family, level) -> primes
+    unordered_map<uint64_t, Zdd::Node> pointsMemo, sharedMemo; // (cube family, level) -> points
+    vector<unordered_map<uint64_t, Zdd::Node>> containingMemo; // per level, (cubes, points) -> cubes
+    vector<unordered_set<uint64_t>> rowsSeen;                  // per level, (cubes, points) visited
+};
+
+#endif // ZDDCOVER_H
@@ -0,0 +1,118 @@
+#include "BatchQueue.h"
+#include "Minimizer.h"
+#include "Trace.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Usage:
+//   batch enqueue <queue dir> <spec files...>
+//   batch work <queue dir> [worker id] [-trace <file>]
+//                                          run until pending/ is empty; -trace
+//                                          writes the worker's timeline (Trace.h)
+//   batch requeue <queue dir> [worker id]  return specs of dead workers
+//   batch merge <queue dir>                merge the per-worker timing reports
+// Start as many "work" processes as wanted, on any machine that mounts the
+// queue directory; see BatchQueue.h for the layout.
+static int usage(const char *program) {
+    cerr << "Usage: " << program << " enqueue <queue> <spec files...>\n"
+         << "       " << program << " work <queue> [worker id] [-trace <file>]\n"
+         << "       " << program << " requeue <queue> [worker id]\n"
+         << "       " << program << " merge <queue>" << endl;
+    return 1;
+}
+
+static string formatResult(const MinimizeResult &result) {
+    string text = statusName(result.status);
+    text += "\n";
+    if (!result.error.empty()) text += "error: " + result.error + "\n";
+    for (const auto &expression : result.expressions) text += "F = " + expression + "\n";
+    return text;
+}
+
+static int work(BatchQueue &queue, const string &worker, const string &tracePath) {
+    // One spec at a time per process; the cover blocks of each spec still
+    // use every core of this machine
+    MinimizeOptions options;
+    BatchQueue::Claim claim;
+    size_t processed = 0;
+    if (!tracePath.empty()) Trace::start();
+    while (queue.claim(worker, claim)) {
+        ifstream in(claim.path);
+        stringstream spec;
+        spec << in.rdbuf();
+
+        MinimizeResult result;
+        auto start = chrono::steady_clock::now();
+        Status status = minimize(spec.str(), result, options);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        string error;
+        if (!queue.publish(claim, worker, formatResult(result), error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        stringstream line;
+        line << claim.spec << '\t' << worker << '\t' << statusName(status) << '\t' << fixed
+             << setprecision(3) << ms << '\t' << result.numVariables << '\t'
+             << (result.solutions.empty() ? 0 : result.solutions[0].size());
+        queue.report(worker, line.str());
+        processed++;
+    }
+    cout << worker << ": " << processed << " specs" << endl;
+    if (!tracePath.empty()) {
+        Trace::stop();
+        string error;
+        if (!Trace::write(tracePath, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) return usage(argv[0]);
+    string command = argv[1];
+    BatchQueue queue(argv[2]);
+    string error;
+    if (!queue.create(error)) {
+        cerr << "Error: " << error << endl;
+        return 1;
+    }
+
+    if (command == "enqueue") {
+        vector<string> files(argv + 3, argv + argc);
+        size_t queued = queue.enqueue(files, error);
+        if (!error.empty()) cerr << "Error: " << error << endl;
+        cout << queued << " specs queued" << endl;
+        return error.empty() ? 0 : 1;
+    }
+    if (command == "work") {
+        string worker = BatchQueue::defaultWorkerId(), tracePath;
+        for (int i = 3; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "-trace" && i + 1 < argc) tracePath = argv[++i];
+            else worker = arg;
+        }
+        return work(queue, worker, tracePath);
+    }
+    if (command == "requeue") {
+        cout << queue.requeue(argc > 3 ? argv[3] : "") << " specs returned to pending" << endl;
+        return 0;
+    }
+    if (command == "merge") {
+        if (!queue.mergeReports(cout, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        return 0;
+    }
+    return usage(argv[0]);
+}
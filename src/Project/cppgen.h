@@ -0,0 +1,112 @@
+// cppgen.h
+#ifndef CPPGEN_H
+#define CPPGEN_H
+
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <iomanip>
+#include <cctype>
+
+// Writes a self-contained C++ header evaluating a minimized cover.
+// cover holds cubes over {0,1,-} with variable A first, and x in the
+// generated code is numbered like the minterms (bit numVariables-1 is A).
+// The header has constexpr cube tables (name_care / name_bits), a
+// branch-free inline bool name(uint32_t x) that ORs one mask compare per
+// cube, and for numVariables <= 16 a bit-packed truth table with
+// name_lookup(x). complemented emits the complement of the cover, for a
+// dual-phase result won by F'.
+inline std::string generateCppHeader(const std::vector<std::string>& cover, int numVariables,
+                                     const std::string& name = "F", bool complemented = false) {
+    std::vector<uint32_t> care, bits;
+    for (const auto& cube : cover) {
+        uint32_t c = 0, b = 0;
+        for (char ch : cube) {
+            c = (c << 1) | (ch != '-');
+            b = (b << 1) | (ch == '1');
+        }
+        care.push_back(c);
+        bits.push_back(b);
+    }
+
+    // The F = ... line the command line prints, for the header comment
+    std::string expression;
+    for (const auto& cube : cover) {
+        if (!expression.empty()) expression += " + ";
+        std::string product;
+        for (size_t i = 0; i < cube.size(); i++) {
+            if (cube[i] == '-') continue;
+            product += char('A' + i);
+            if (cube[i] == '0') product += "'";
+        }
+        expression += product.empty() ? "1" : product;
+    }
+    if (expression.empty()) expression = "0";
+    if (complemented) expression = "(" + expression + ")'";
+
+    std::string guard;
+    for (char ch : name) guard += std::isalnum(static_cast<unsigned char>(ch)) ? std::toupper(ch) : '_';
+    guard = "QUINIFY_" + guard + "_H";
+
+    auto hex = [](uint32_t value) {
+        std::stringstream s;
+        s << "0x" << std::hex << std::uppercase << value << "u";
+        return s.str();
+    };
+
+    std::stringstream out;
+    out << "// Generated by Quinify: " << name << " = " << expression << "\n";
+    out << "#ifndef " << guard << "\n#define " << guard << "\n\n#include <cstdint>\n\n";
+    out << "// x is numbered like the minterms: bit " << numVariables - 1 << " is A\n";
+    out << "constexpr int " << name << "_numVariables = " << numVariables << ";\n";
+    out << "constexpr int " << name << "_cubeCount = " << cover.size() << ";\n";
+
+    // Cube tables: x is inside cube i when (x & care[i]) == bits[i]
+    if (!cover.empty()) {
+        out << "constexpr uint32_t " << name << "_care[] = {";
+        for (size_t i = 0; i < care.size(); i++) out << (i ? ", " : " ") << hex(care[i]);
+        out << " };\n";
+        out << "constexpr uint32_t " << name << "_bits[] = {";
+        for (size_t i = 0; i < bits.size(); i++) out << (i ? ", " : " ") << hex(bits[i]);
+        out << " };\n";
+    }
+
+    // Branch-free: compares are combined with | rather than ||
+    out << "\ninline bool " << name << "(uint32_t x) {\n";
+    if (cover.empty()) {
+        out << "    (void)x;\n    return " << (complemented ? "true" : "false") << ";\n";
+    } else {
+        out << "    return " << (complemented ? "!(" : "(");
+        for (size_t i = 0; i < cover.size(); i++) {
+            if (i) out << "\n        | ";
+            out << "((x & " << hex(care[i]) << ") == " << hex(bits[i]) << ")";
+        }
+        out << ");\n";
+    }
+    out << "}\n";
+
+    if (numVariables <= 16) {
+        size_t points = size_t(1) << numVariables;
+        std::vector<uint64_t> table((points + 63) / 64, 0);
+        for (size_t x = 0; x < points; x++) {
+            bool value = false;
+            for (size_t i = 0; i < cover.size() && !value; i++) value = (x & care[i]) == bits[i];
+            if (value != complemented) table[x >> 6] |= uint64_t(1) << (x & 63);
+        }
+        out << "\n// Bit x of the table is " << name << "(x)\n";
+        out << "constexpr uint64_t " << name << "_table[] = {";
+        for (size_t w = 0; w < table.size(); w++) {
+            out << (w % 4 ? " " : "\n    ") << "0x" << std::hex << std::setw(16) << std::setfill('0')
+                << table[w] << std::dec << "ull" << (w + 1 < table.size() ? "," : "");
+        }
+        out << "\n};\n\n";
+        out << "inline bool " << name << "_lookup(uint32_t x) {\n";
+        out << "    return (" << name << "_table[x >> 6] >> (x & 63)) & 1;\n}\n";
+    }
+
+    out << "\n#endif // " << guard << "\n";
+    return out.str();
+}
+
+#endif // CPPGEN_H
@@ -0,0 +1,69 @@
+#include "Pla.h"
+#include "Trace.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Usage: pla <input.pla> [output.pla] [-dual] [-trace <trace.json>]
+// Minimizes every output of a PLA file and writes the covers as a PLA,
+// to standard output when no output file is given. -trace writes a
+// timeline of the run per thread (see Trace.h).
+int main(int argc, char *argv[]) {
+    string inputPath, outputPath, tracePath;
+    MinimizeOptions options;
+    options.allSolutions = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-dual") options.dualPhase = true;
+        else if (arg == "-trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (inputPath.empty()) inputPath = arg;
+        else outputPath = arg;
+    }
+    if (inputPath.empty()) {
+        cerr << "Usage: " << argv[0] << " <input.pla> [output.pla] [-dual] [-trace <trace.json>]" << endl;
+        return 1;
+    }
+
+    ifstream in(inputPath);
+    if (!in) {
+        cerr << "Error: Unable to open " << inputPath << endl;
+        return 1;
+    }
+    Pla pla;
+    Status status = pla.read(in);
+    if (status != Status::Ok) {
+        cerr << "Error: " << inputPath << ": " << pla.error << endl;
+        return 1;
+    }
+
+    if (!tracePath.empty()) Trace::start();
+    vector<MinimizeResult> results(pla.numOutputs);
+    for (int j = 0; j < pla.numOutputs; j++) {
+        results[j].numVariables = pla.numInputs;
+        if (pla.onSets[j].empty()) continue; // constant 0: no rows
+        status = minimize(pla.numInputs, pla.onSets[j], pla.dcSets[j], results[j], options);
+        if (status != Status::Ok && status != Status::AlwaysOne) {
+            cerr << "Error: output " << j << ": " << results[j].error << endl;
+            return 1;
+        }
+    }
+    if (!tracePath.empty()) {
+        Trace::stop();
+        string error;
+        if (!Trace::write(tracePath, error)) cerr << "Error: " << error << endl;
+    }
+
+    if (outputPath.empty()) {
+        Pla::write(cout, results, pla.inputLabels, pla.outputLabels);
+        return 0;
+    }
+    ofstream out(outputPath);
+    if (!out) {
+        cerr << "Error: Unable to open " << outputPath << endl;
+        return 1;
+    }
+    Pla::write(out, results, pla.inputLabels, pla.outputLabels);
+    return 0;
+}
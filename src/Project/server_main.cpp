@@ -0,0 +1,26 @@
+#include "Server.h"
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Usage: server <socket path> [worker threads] [warm variables]
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <socket path> [threads] [warm variables]" << endl;
+        return 1;
+    }
+    size_t threads = argc > 2 ? stoul(argv[2]) : thread::hardware_concurrency();
+    int warmVariables = argc > 3 ? stoi(argv[3]) : Server::MaxWarmVariables;
+    if (warmVariables < 0 || warmVariables > Server::MaxWarmVariables) {
+        cerr << "Error: warm variables must be between 0 and " << Server::MaxWarmVariables << "." << endl;
+        return 1;
+    }
+
+    Server server(argv[1], threads);
+    cout << "Warming result cache for functions up to " << warmVariables << " variables" << endl;
+    server.warm(warmVariables);
+    cout << "Quinify server listening on " << argv[1] << endl;
+    return server.run();
+}
@@ -11,7 +11,12 @@
 #include <sstream>
 #include <cctype>
 
-std::string generateVerilogModule(const std::string& expression, const std::string& moduleName = "boolean_logic") {
+// A sum of products ("AB' + C") becomes AND gates into an OR; a product of
+// sums ("(A' + B)(C)", a complemented dual-phase result) becomes OR gates
+// into an AND
+inline std::string generateVerilogModule(const std::string& expression, const std::string& moduleName = "boolean_logic") {
+    bool productOfSums = expression.find('(') != std::string::npos;
+
     // Identify variables in the expression
     std::set<char> variables;
     for (char c : expression) {
@@ -43,12 +48,22 @@ std::string generateVerilogModule(const std::string& expression, const std::stri
     verilog << " output F\n";
     verilog << ");\n\n";
 
-    // Parse expression into product terms (split by +)
+    // Parse expression into product terms (split by +), or sum terms (one
+    // per pair of parentheses)
     std::vector<std::string> terms;
     std::string currentTerm;
     for (size_t i = 0; i < expression.size(); i++) {
         char c = expression[i];
-        if (c == '+') {
+        if (productOfSums) {
+            if (c == '(') {
+                currentTerm.clear();
+            } else if (c == ')') {
+                terms.push_back(currentTerm);
+                currentTerm.clear();
+            } else if (!std::isspace(static_cast<unsigned char>(c))) {
+                currentTerm += c;
+            }
+        } else if (c == '+') {
             if (!currentTerm.empty()) {
                 // Remove whitespace - FIX: Use a lambda instead of isspace directly
                 currentTerm.erase(std::remove_if(currentTerm.begin(), currentTerm.end(), 
@@ -76,7 +91,9 @@ std::string generateVerilogModule(const std::string& expression, const std::stri
         verilog << " wire " << var << "_n;\n";
     }
 
-    verilog << "\n // Product term wires\n";
+    const char* termGate = productOfSums ? "or" : "and";
+    const char* outputGate = productOfSums ? "and" : "or";
+    verilog << (productOfSums ? "\n // Sum term wires\n" : "\n // Product term wires\n");
     for (size_t i = 0; i < terms.size(); i++) {
         verilog << " wire term" << i << "; // " << terms[i] << "\n";
     }
@@ -87,8 +104,8 @@ std::string generateVerilogModule(const std::string& expression, const std::stri
         verilog << " not not_" << var << "(" << var << "_n, " << var << ");\n";
     }
 
-    // Generate AND gates for product terms
-    verilog << "\n // AND gates for product terms\n";
+    // Generate AND gates for product terms (OR gates for sum terms)
+    verilog << (productOfSums ? "\n // OR gates for sum terms\n" : "\n // AND gates for product terms\n");
     for (size_t i = 0; i < terms.size(); i++) {
         std::string term = terms[i];
         std::vector<std::string> inputSignals;
@@ -113,8 +130,8 @@ std::string generateVerilogModule(const std::string& expression, const std::stri
             // Single input - use a buffer
             verilog << " assign term" << i << " = " << inputSignals[0] << ";\n";
         } else {
-            // Multiple inputs - use AND gate
-            verilog << " and and_term" << i << "(term" << i;
+            // Multiple inputs - use AND gate (OR for a sum)
+            verilog << " " << termGate << " " << termGate << "_term" << i << "(term" << i;
             for (const auto& signal : inputSignals) {
                 verilog << ", " << signal;
             }
@@ -125,12 +142,12 @@ std::string generateVerilogModule(const std::string& expression, const std::stri
     // Generate OR gate for the output
     verilog << "\n // Output logic\n";
     if (terms.empty()) {
-        verilog << " assign F = 1'b0; // Empty expression\n";
+        verilog << " assign F = " << (productOfSums ? "1'b1" : "1'b0") << "; // Empty expression\n";
     } else if (terms.size() == 1) {
         verilog << " assign F = term0;\n";
     } else {
-        // Use OR gate with multiple inputs
-        verilog << " or or_out(F";
+        // Use OR gate with multiple inputs (AND for a product of sums)
+        verilog << " " << outputGate << " " << outputGate << "_out(F";
         for (size_t i = 0; i < terms.size(); i++) {
             verilog << ", term" << i;
         }
@@ -143,7 +160,7 @@ std::string generateVerilogModule(const std::string& expression, const std::stri
     return verilog.str();
 }
 
-void generateVerilogFiles(const std::vector<std::string>& minimizedExpressions) {
+inline void generateVerilogFiles(const std::vector<std::string>& minimizedExpressions) {
     for (size_t i = 0; i < minimizedExpressions.size(); i++) {
         std::string moduleName = "minimized_logic_" + std::to_string(i);
         std::string verilogCode = generateVerilogModule(minimizedExpressions[i], moduleName);